@@ -0,0 +1,67 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include "alloccount.h"
+
+#ifdef __GLIBC__
+void *__libc_malloc(size_t sz);
+void *__libc_calloc(size_t n, size_t sz);
+void *__libc_realloc(void *p, size_t sz);
+
+static __thread unsigned long nalloc;
+
+void *malloc(size_t sz)
+{
+	nalloc++;
+	return __libc_malloc(sz);
+}
+
+void *calloc(size_t n, size_t sz)
+{
+	nalloc++;
+	return __libc_calloc(n, sz);
+}
+
+void *realloc(void *p, size_t sz)
+{
+	nalloc++;
+	return __libc_realloc(p, sz);
+}
+
+int alloc_counting(void)
+{
+	return 1;
+}
+
+unsigned long alloc_count(void)
+{
+	return nalloc;
+}
+
+#else	/* !__GLIBC__ */
+
+int alloc_counting(void)
+{
+	return 0;
+}
+
+unsigned long alloc_count(void)
+{
+	return 0;
+}
+#endif
@@ -0,0 +1,37 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ALLOCCOUNT_H_
+#define ALLOCCOUNT_H_
+
+/* number of heap allocations made by the calling thread so far. The counting
+ * malloc replaces the C library one for the whole process, Qt included, and
+ * is only available with glibc; elsewhere this always returns 0.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int alloc_counting(void);
+unsigned long alloc_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* ALLOCCOUNT_H_ */
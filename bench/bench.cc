@@ -0,0 +1,517 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <QApplication>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QEventLoop>
+#include <QSocketNotifier>
+#include <QTimer>
+#define SPNAV_CONFIG_H_
+#include <spnav.h>
+#include "src/spnavcfg.h"
+#include "src/spnavio.h"
+#include "src/appwatch.h"
+#include "src/cfgwr.h"
+#include "src/keysym.h"
+#include "src/perfstat.h"
+#include "src/ui.h"
+#include "src/util.h"
+#include "stubspnav.h"
+#include "alloccount.h"
+#include "xfocus.h"
+
+/* every measurement runs for at least BENCH_MIN_ITER iterations, and then
+ * until BENCH_USEC have passed or BENCH_MAX_ITER iterations are done
+ */
+#define BENCH_MIN_ITER	5
+#define BENCH_MAX_ITER	100000
+#define BENCH_USEC		300000
+
+/* event rate sweep: 0 is as fast as possible */
+#define FEED_USEC		500000
+#define FEED_MAX_EVENTS	20000
+#define FEED_TIMEOUT	10000
+
+struct result {
+	double usec;
+	double nreq;
+	double nalloc;
+};
+
+struct feed {
+	int rate;
+	int count;
+	int nbuttons;
+};
+
+static void parse_args(int argc, char **argv);
+static int run_checks(void);
+static void bench_read(int nbuttons, long latency);
+static void bench_updateui(int nbuttons);
+static void bench_input(int nbuttons, int rate);
+static void measure(void (*func)(int), struct result *res);
+static bool wait_until(bool (*cond)(void), long msec);
+static void *feeder(void *arg);
+
+/* the GUI objects expect these from main.cc */
+MainWin *mainwin;
+
+void startup_complete(const struct io_snapshot *snap)
+{
+}
+
+static int shapes[] = {2, 15, 31, 128};
+static long latencies[] = {0, 20, 100};
+static int rates[] = {500, 2000, 8000, 0};
+static int num_shapes = sizeof shapes / sizeof *shapes;
+static int num_latencies = sizeof latencies / sizeof *latencies;
+
+static struct device_info bench_dev;
+static struct config bench_cfg;
+static int want_nbuttons;
+static bool check_only;
+
+static int check_failed;
+
+#define CHECK(expr) \
+	do { \
+		if(!(expr)) { \
+			fprintf(stderr, "check failed: %s (%s:%d)\n", #expr, __FILE__, __LINE__); \
+			check_failed++; \
+		} \
+	} while(0)
+
+int main(int argc, char **argv)
+{
+	parse_args(argc, argv);
+
+	/* don't clobber an explicit choice, for running under a real display */
+	setenv("QT_QPA_PLATFORM", "offscreen", 0);
+	QCoreApplication::setApplicationName("spnavcfg");
+	QApplication app(argc, argv);
+
+	MainWin w;
+	w.show();
+	mainwin = &w;
+	if(!w.init()) {
+		return 1;
+	}
+
+	/* benchmarking broken code is pointless, the checks go first */
+	if(run_checks() == -1 || check_only) {
+		return check_failed ? 1 : 0;
+	}
+
+	if(!alloc_counting()) {
+		printf("allocation counting is only available with glibc\n\n");
+	}
+
+	printf("read_devinfo / read_cfg (per call)\n");
+	printf("%8s %8s | %10s %6s %7s | %10s %6s %7s\n", "buttons", "latency",
+			"devinfo us", "reqs", "allocs", "cfg us", "reqs", "allocs");
+	for(int i=0; i<num_shapes; i++) {
+		for(int j=0; j<num_latencies; j++) {
+			bench_read(shapes[i], latencies[j]);
+		}
+	}
+	stub_set_latency(0);
+
+	printf("\nMainWin::updateui (per call)\n");
+	printf("%8s | %12s %7s | %12s %7s | %12s %7s\n", "buttons", "new dev us",
+			"allocs", "no-op us", "allocs", "1 change us", "allocs");
+	for(int i=0; i<num_shapes; i++) {
+		bench_updateui(shapes[i]);
+	}
+
+	printf("\nspnav_input throughput\n");
+	printf("%8s %8s | %10s %9s %10s %9s %8s\n", "buttons", "rate", "events/s",
+			"cpu us/ev", "ev/wakeup", "allocs/ev", "dropped");
+
+	stub_set_device(shapes[0], 6);
+	int fd = spnavio_start();
+	if(fd == -1) {
+		fprintf(stderr, "failed to start the I/O thread\n");
+		return 1;
+	}
+	QSocketNotifier sockev(fd, QSocketNotifier::Read);
+	QObject::connect(&sockev, &QSocketNotifier::activated, &w, &MainWin::spnav_input);
+
+	for(int i=0; i<num_shapes; i++) {
+		/* switch devices by restarting the daemon, the GUI reconnects */
+		want_nbuttons = shapes[i];
+		if(i > 0) {
+			stub_set_device(shapes[i], 6);
+			stub_restart();
+		}
+		if(!wait_until([] { return spnavio_status() == IO_CONNECTED &&
+					devinfo.nbuttons == want_nbuttons; }, FEED_TIMEOUT)) {
+			fprintf(stderr, "timed out waiting for a %d button device\n", shapes[i]);
+			break;
+		}
+		/* the GUI only subscribes to what's on screen, feed it everything */
+		spnavio_set_evmask(SPNAV_EVMASK_ALL);
+		for(int rate : rates) {
+			bench_input(shapes[i], rate);
+		}
+	}
+
+	spnavio_stop();
+	return 0;
+}
+
+static void parse_args(int argc, char **argv)
+{
+	for(int i=1; i<argc; i++) {
+		if(strcmp(argv[i], "--buttons") == 0 && argv[i + 1]) {
+			shapes[0] = atoi(argv[++i]);
+			if(shapes[0] < 1) shapes[0] = 1;
+			num_shapes = 1;
+		} else if(strcmp(argv[i], "--latency") == 0 && argv[i + 1]) {
+			latencies[0] = atol(argv[++i]);
+			num_latencies = 1;
+		} else if(strcmp(argv[i], "--check") == 0) {
+			check_only = true;
+		} else {
+			printf("usage: %s [--buttons <n>] [--latency <usec>] [--check]\n", argv[0]);
+			printf("  --buttons: benchmark a single device size (default: 2, 15, 31, 128)\n");
+			printf("  --latency: per request latency of the stub daemon (default: 0, 20, 100)\n");
+			printf("  --check: only run the correctness checks\n");
+			exit(strcmp(argv[i], "--help") == 0 ? 0 : 1);
+		}
+	}
+}
+
+static void measure(void (*func)(int), struct result *res)
+{
+	unsigned long iter = 0;
+	unsigned long req0 = stub_requests();
+	unsigned long alloc0 = alloc_count();
+	long long t0 = get_usec();
+	long long dt;
+
+	do {
+		func(iter++);
+		dt = get_usec() - t0;
+	} while(iter < BENCH_MIN_ITER || (dt < BENCH_USEC && iter < BENCH_MAX_ITER));
+
+	res->usec = (double)dt / iter;
+	res->nreq = (double)(stub_requests() - req0) / iter;
+	res->nalloc = (double)(alloc_count() - alloc0) / iter;
+}
+
+static void bench_read(int nbuttons, long latency)
+{
+	struct result rdev, rcfg;
+
+	stub_set_device(nbuttons, 6);
+	stub_set_latency(latency);
+	if(spnav_open() == -1) {
+		perror("spnav_open");
+		return;
+	}
+
+	measure([](int) { read_devinfo(&bench_dev); }, &rdev);
+	measure([](int) { read_cfg(&bench_cfg, &bench_dev); }, &rcfg);
+
+	printf("%8d %8ld | %10.2f %6.1f %7.1f | %10.2f %6.1f %7.1f\n", nbuttons, latency,
+			rdev.usec, rdev.nreq, rdev.nalloc, rcfg.usec, rcfg.nreq, rcfg.nalloc);
+	spnav_close();
+}
+
+static void set_device(int nbuttons)
+{
+	free(devinfo.name);
+	free(devinfo.path);
+	devinfo.name = strdup("stub device");
+	devinfo.path = strdup("/dev/null");
+	devinfo.naxes = 6;
+	devinfo.nbuttons = nbuttons;
+	default_cfg(&cfg);
+}
+
+/* an edit made through a widget, which is then reverted from the outside (a
+ * reset to defaults, another client), has to show the reverted value
+ */
+static void check_external_revert(void)
+{
+	QDoubleSpinBox *spin = mainwin->findChild<QDoubleSpinBox*>("spin_sens");
+	QCheckBox *chk = mainwin->findChild<QCheckBox*>("chk_grab");
+
+	CHECK(spin && chk);
+	if(!spin || !chk) return;
+
+	set_device(2);
+	mainwin->updateui();
+
+	spin->setValue(2.5);
+	chk->setChecked(!cfg.grab);
+	CHECK(cfg.sens == 2.5f);
+
+	default_cfg(&cfg);
+	cfgwr_sync(&cfg);
+	mainwin->updateui();
+	CHECK(spin->value() == cfg.sens);
+	CHECK(chk->isChecked() == (cfg.grab != 0));
+}
+
+/* the XF86 vendor keysyms are common button bindings, and have to resolve
+ * like Xlib resolves them, both ways
+ */
+static void check_keysyms(void)
+{
+	static const char *names[] = {"Escape", "XF86AudioPlay", "XF86AudioRaiseVolume", 0};
+
+	for(int i=0; names[i]; i++) {
+		long sym = keysym_lookup(names[i]);
+		const char *name = keysym_name(sym);
+		CHECK(sym != 0);
+		CHECK(name && strcmp(name, names[i]) == 0);
+	}
+	CHECK(keysym_lookup("XF86AudioPlay") == 0x1008ff14);
+}
+
+/* waits for the application watcher to name a profile */
+static bool wait_profile(int fd, char *name, int namesz)
+{
+	struct pollfd pfd;
+	long long end = get_usec() + 2000000;
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	while(get_usec() < end) {
+		if(poll(&pfd, 1, 100) > 0 && appwatch_poll(name, namesz) != -1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* the application watcher has to follow _NET_ACTIVE_WINDOW, and the WM_CLASS
+ * of the focused window as it changes. Needs an X server, Xvfb will do.
+ */
+static void check_appwatch(void)
+{
+	char dir[] = "/tmp/spnavcfg-bench.XXXXXX";
+	char confdir[64], path[96], name[256];
+	char *prev_xdg;
+	FILE *fp;
+	int fd;
+
+	if(!getenv("DISPLAY") || xfocus_open() == -1) {
+		printf("no X server, skipping the application watcher check\n");
+		return;
+	}
+
+	if(!mkdtemp(dir)) {
+		CHECK(!"failed to create a temporary directory");
+		xfocus_close();
+		return;
+	}
+	snprintf(confdir, sizeof confdir, "%s/spnavcfg", dir);
+	snprintf(path, sizeof path, "%s/apps.conf", confdir);
+	mkdir(confdir, 0700);
+	if((fp = fopen(path, "w"))) {
+		fputs("spnavbench-cad = cad\nspnavbench-game = game\n", fp);
+		fclose(fp);
+	}
+
+	/* the rules are only read by appwatch_start */
+	prev_xdg = getenv("XDG_CONFIG_HOME") ? strdup(getenv("XDG_CONFIG_HOME")) : 0;
+	setenv("XDG_CONFIG_HOME", dir, 1);
+	fd = appwatch_start();
+	if(prev_xdg) {
+		setenv("XDG_CONFIG_HOME", prev_xdg, 1);
+		free(prev_xdg);
+	} else {
+		unsetenv("XDG_CONFIG_HOME");
+	}
+
+	CHECK(fd != -1);
+	if(fd != -1) {
+		xfocus_new_window("spnavbench-cad");
+		CHECK(wait_profile(fd, name, sizeof name) && strcmp(name, "cad") == 0);
+
+		/* a late WM_CLASS change of the focused window */
+		xfocus_set_class("spnavbench-game");
+		CHECK(wait_profile(fd, name, sizeof name) && strcmp(name, "game") == 0);
+		appwatch_stop();
+	}
+	xfocus_close();
+
+	unlink(path);
+	rmdir(confdir);
+	rmdir(dir);
+}
+
+/* returns -1 if any check failed */
+static int run_checks(void)
+{
+	check_external_revert();
+	check_keysyms();
+	check_appwatch();
+
+	printf("checks: %s\n\n", check_failed ? "FAILED" : "ok");
+	return check_failed ? -1 : 0;
+}
+
+static void bench_updateui(int nbuttons)
+{
+	struct result rdev, rnop, rone;
+
+	set_device(nbuttons);
+
+	/* a new device, alternating between two button counts */
+	want_nbuttons = nbuttons;
+	measure([](int i) {
+		devinfo.nbuttons = (i & 1) && want_nbuttons > 1 ? want_nbuttons - 1 : want_nbuttons;
+		mainwin->updateui();
+	}, &rdev);
+	devinfo.nbuttons = nbuttons;
+	mainwin->updateui();
+
+	measure([](int) { mainwin->updateui(); }, &rnop);
+	measure([](int i) {
+		cfg.sens = i & 1 ? 1.5f : 1.0f;
+		mainwin->updateui();
+	}, &rone);
+
+	printf("%8d | %12.2f %7.1f | %12.2f %7.1f | %12.2f %7.1f\n", nbuttons,
+			rdev.usec, rdev.nalloc, rnop.usec, rnop.nalloc, rone.usec, rone.nalloc);
+}
+
+static unsigned long input_target, input_base;
+
+static unsigned long input_consumed(void)
+{
+	return perfstat.events[SPNAV_EVENT_MOTION] + perfstat.events[SPNAV_EVENT_RAWBUTTON] +
+		spnavio_dropped();
+}
+
+static void bench_input(int nbuttons, int rate)
+{
+	struct feed feed;
+	struct timespec cpu0, cpu1;
+	pthread_t thr;
+	unsigned long wakeups, alloc0, dropped0;
+	long long t0, dt;
+	double cpu_usec;
+
+	feed.rate = rate;
+	feed.count = rate > 0 ? (int)((long long)rate * FEED_USEC / 1000000) : FEED_MAX_EVENTS;
+	feed.nbuttons = nbuttons;
+
+	input_base = input_consumed();
+	input_target = input_base + feed.count;
+	dropped0 = spnavio_dropped();
+	wakeups = perfstat.wakeups;
+	alloc0 = alloc_count();
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
+	t0 = get_usec();
+
+	if(pthread_create(&thr, 0, feeder, &feed) != 0) {
+		perror("pthread_create");
+		return;
+	}
+	bool done = wait_until([] { return input_consumed() >= input_target; }, FEED_TIMEOUT);
+	pthread_join(thr, 0);
+
+	dt = get_usec() - t0;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
+	cpu_usec = (cpu1.tv_sec - cpu0.tv_sec) * 1e6 + (cpu1.tv_nsec - cpu0.tv_nsec) / 1e3;
+	wakeups = perfstat.wakeups - wakeups;
+
+	char ratestr[16];
+	if(rate > 0) {
+		sprintf(ratestr, "%d", rate);
+	} else {
+		strcpy(ratestr, "max");
+	}
+	printf("%8d %8s | %10.0f %9.2f %10.1f %9.2f %8lu%s\n", nbuttons, ratestr,
+			feed.count * 1e6 / dt, cpu_usec / feed.count,
+			wakeups ? (double)feed.count / wakeups : 0.0,
+			(double)(alloc_count() - alloc0) / feed.count,
+			spnavio_dropped() - dropped0, done ? "" : " (timed out)");
+}
+
+/* runs the event loop until cond is true, or msec have passed */
+static bool wait_until(bool (*cond)(void), long msec)
+{
+	QEventLoop loop;
+	QTimer poll;
+
+	if(cond()) return true;
+
+	poll.setInterval(2);
+	QObject::connect(&poll, &QTimer::timeout, &loop, [&loop, cond] {
+		if(cond()) loop.quit();
+	});
+	poll.start();
+	QTimer::singleShot(msec, &loop, &QEventLoop::quit);
+	loop.exec();
+	return cond();
+}
+
+/* pushes motion events, with a button press or release every 16th, on a fixed
+ * schedule
+ */
+static void *feeder(void *arg)
+{
+	struct feed *feed = (struct feed*)arg;
+	spnav_event ev;
+	int bn = 0, press = 1;
+	long long t0 = get_usec();
+
+	for(int i=0; i<feed->count; i++) {
+		if(feed->rate > 0) {
+			long long wait = t0 + (long long)i * 1000000 / feed->rate - get_usec();
+			if(wait > 0) usleep(wait);
+		}
+
+		memset(&ev, 0, sizeof ev);
+		if((i & 15) == 15) {
+			ev.type = SPNAV_EVENT_RAWBUTTON;
+			ev.button.press = press;
+			ev.button.bnum = bn;
+			if(!press) {
+				bn = (bn + 1) % feed->nbuttons;
+			}
+			press = !press;
+		} else {
+			ev.type = SPNAV_EVENT_MOTION;
+			ev.motion.x = i % 701 - 350;
+			ev.motion.y = -ev.motion.x;
+			ev.motion.z = i % 301 - 150;
+			ev.motion.rx = ev.motion.ry = ev.motion.rz = i % 101 - 50;
+			ev.motion.data = &ev.motion.x;
+		}
+
+		/* back off while the stub's queue is full */
+		while(stub_push_event(&ev) == -1) {
+			usleep(100);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,486 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include "stubspnav.h"
+
+#define STUB_MAX_AXES		64
+#define STUB_MAX_BUTTONS	256
+#define STUB_EVQ_SIZE		65536
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int sv[2] = {-1, -1};
+
+static int dev_nbuttons = 2, dev_naxes = 6;
+static int nbuttons, naxes;
+static long latency_usec;
+static atomic_ulong nreq;
+
+static spnav_event evq[STUB_EVQ_SIZE];
+static unsigned int evq_head, evq_tail;
+
+/* "daemon" configuration */
+static float sens;
+static float axis_sens[6];
+static int invert, swapyz, led, grab, repeat;
+static int deadzone[STUB_MAX_AXES];
+static int axismap[STUB_MAX_AXES];
+static int bnmap[STUB_MAX_BUTTONS];
+static int bnaction[STUB_MAX_BUTTONS];
+static int kbmap[STUB_MAX_BUTTONS];
+static char *serdev;
+static int cfg_valid;
+
+static void reset_cfg(void)
+{
+	int i;
+
+	sens = 1.0f;
+	for(i=0; i<6; i++) {
+		axis_sens[i] = 1.0f;
+	}
+	invert = swapyz = 0;
+	led = 1;
+	grab = 0;
+	repeat = -1;
+	for(i=0; i<STUB_MAX_AXES; i++) {
+		deadzone[i] = 2;
+		axismap[i] = i < 6 ? i : -1;
+	}
+	for(i=0; i<STUB_MAX_BUTTONS; i++) {
+		bnmap[i] = i;
+		bnaction[i] = 0;
+		kbmap[i] = 0;
+	}
+	free(serdev);
+	serdev = 0;
+}
+
+/* one round trip to the daemon */
+static void request(void)
+{
+	struct timespec ts;
+	long long end;
+
+	atomic_fetch_add_explicit(&nreq, 1, memory_order_relaxed);
+	if(latency_usec <= 0) return;
+
+	/* busy-wait, sleeping isn't precise enough for tens of microseconds */
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	end = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 + latency_usec;
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+	} while(ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 < end);
+}
+
+void stub_set_device(int nb, int nax)
+{
+	pthread_mutex_lock(&lock);
+	dev_nbuttons = nb < STUB_MAX_BUTTONS ? nb : STUB_MAX_BUTTONS;
+	dev_naxes = nax < STUB_MAX_AXES ? nax : STUB_MAX_AXES;
+	pthread_mutex_unlock(&lock);
+}
+
+void stub_set_latency(long usec)
+{
+	latency_usec = usec;
+}
+
+unsigned long stub_requests(void)
+{
+	return atomic_load(&nreq);
+}
+
+int stub_push_event(const spnav_event *ev)
+{
+	int res = -1;
+
+	pthread_mutex_lock(&lock);
+	if(sv[1] != -1 && evq_head - evq_tail < STUB_EVQ_SIZE) {
+		/* one byte on the socket means "events pending" */
+		if(evq_head == evq_tail) {
+			while(write(sv[1], "e", 1) == -1 && errno == EINTR);
+		}
+		evq[evq_head++ & (STUB_EVQ_SIZE - 1)] = *ev;
+		res = 0;
+	}
+	pthread_mutex_unlock(&lock);
+	return res;
+}
+
+void stub_restart(void)
+{
+	pthread_mutex_lock(&lock);
+	if(sv[1] != -1) {
+		close(sv[1]);
+		sv[1] = -1;
+	}
+	evq_head = evq_tail = 0;
+	reset_cfg();
+	pthread_mutex_unlock(&lock);
+}
+
+
+int spnav_open(void)
+{
+	int res = 0;
+
+	pthread_mutex_lock(&lock);
+	if(sv[0] != -1) {
+		close(sv[0]);
+	}
+	if(sv[1] != -1) {
+		close(sv[1]);
+	}
+	if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1) {
+		sv[0] = sv[1] = -1;
+		res = -1;
+	} else {
+		fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+		nbuttons = dev_nbuttons;
+		naxes = dev_naxes;
+		evq_head = evq_tail = 0;
+		if(!cfg_valid) {
+			reset_cfg();
+			cfg_valid = 1;
+		}
+	}
+	pthread_mutex_unlock(&lock);
+	return res;
+}
+
+int spnav_close(void)
+{
+	pthread_mutex_lock(&lock);
+	if(sv[0] != -1) {
+		close(sv[0]);
+		sv[0] = -1;
+	}
+	pthread_mutex_unlock(&lock);
+	return 0;
+}
+
+int spnav_fd(void)
+{
+	return sv[0];
+}
+
+int spnav_poll_event(spnav_event *ev)
+{
+	char buf[64];
+	int res = 0;
+
+	pthread_mutex_lock(&lock);
+	if(evq_head != evq_tail) {
+		*ev = evq[evq_tail++ & (STUB_EVQ_SIZE - 1)];
+		res = ev->type;
+	}
+	if(evq_head == evq_tail) {
+		/* leaves an EOF in place, for the caller to notice */
+		while(read(sv[0], buf, sizeof buf) > 0);
+	}
+	pthread_mutex_unlock(&lock);
+	return res;
+}
+
+int spnav_wait_event(spnav_event *ev)
+{
+	return spnav_poll_event(ev);
+}
+
+int spnav_protocol(void)
+{
+	request();
+	return 1;
+}
+
+int spnav_client_name(const char *name)
+{
+	request();
+	return 0;
+}
+
+int spnav_evmask(unsigned int mask)
+{
+	request();
+	return 0;
+}
+
+int spnav_dev_name(char *buf, int bufsz)
+{
+	static const char name[] = "stub device";
+
+	request();
+	if(buf && bufsz > 0) {
+		strncpy(buf, name, bufsz - 1);
+		buf[bufsz - 1] = 0;
+	}
+	return sizeof name - 1;
+}
+
+int spnav_dev_path(char *buf, int bufsz)
+{
+	static const char path[] = "/dev/null";
+
+	request();
+	if(buf && bufsz > 0) {
+		strncpy(buf, path, bufsz - 1);
+		buf[bufsz - 1] = 0;
+	}
+	return sizeof path - 1;
+}
+
+int spnav_dev_buttons(void)
+{
+	request();
+	return nbuttons;
+}
+
+int spnav_dev_axes(void)
+{
+	request();
+	return naxes;
+}
+
+int spnav_dev_type(void)
+{
+	request();
+	return SPNAV_DEV_UNKNOWN;
+}
+
+int spnav_cfg_reset(void)
+{
+	request();
+	reset_cfg();
+	return 0;
+}
+
+int spnav_cfg_restore(void)
+{
+	request();
+	return 0;
+}
+
+int spnav_cfg_save(void)
+{
+	request();
+	return 0;
+}
+
+#define CHECK_AXIS(x)	if((x) < 0 || (x) >= naxes) return -1
+#define CHECK_BN(x)		if((x) < 0 || (x) >= nbuttons) return -1
+
+int spnav_cfg_set_sens(float s)
+{
+	request();
+	sens = s;
+	return 0;
+}
+
+float spnav_cfg_get_sens(void)
+{
+	request();
+	return sens;
+}
+
+int spnav_cfg_set_axis_sens(const float *svec)
+{
+	request();
+	memcpy(axis_sens, svec, sizeof axis_sens);
+	return 0;
+}
+
+int spnav_cfg_get_axis_sens(float *svec)
+{
+	request();
+	memcpy(svec, axis_sens, sizeof axis_sens);
+	return 0;
+}
+
+int spnav_cfg_set_invert(int invbits)
+{
+	request();
+	invert = invbits;
+	return 0;
+}
+
+int spnav_cfg_get_invert(void)
+{
+	request();
+	return invert;
+}
+
+int spnav_cfg_set_deadzone(int axis, int delta)
+{
+	request();
+	CHECK_AXIS(axis);
+	deadzone[axis] = delta;
+	return 0;
+}
+
+int spnav_cfg_get_deadzone(int axis)
+{
+	request();
+	CHECK_AXIS(axis);
+	return deadzone[axis];
+}
+
+int spnav_cfg_set_axismap(int axis, int map)
+{
+	request();
+	CHECK_AXIS(axis);
+	axismap[axis] = map;
+	return 0;
+}
+
+int spnav_cfg_get_axismap(int axis)
+{
+	request();
+	CHECK_AXIS(axis);
+	return axismap[axis];
+}
+
+int spnav_cfg_set_bnmap(int bn, int map)
+{
+	request();
+	CHECK_BN(bn);
+	bnmap[bn] = map;
+	return 0;
+}
+
+int spnav_cfg_get_bnmap(int bn)
+{
+	request();
+	CHECK_BN(bn);
+	return bnmap[bn];
+}
+
+int spnav_cfg_set_bnaction(int bn, int act)
+{
+	request();
+	CHECK_BN(bn);
+	bnaction[bn] = act;
+	return 0;
+}
+
+int spnav_cfg_get_bnaction(int bn)
+{
+	request();
+	CHECK_BN(bn);
+	return bnaction[bn];
+}
+
+int spnav_cfg_set_kbmap(int bn, int key)
+{
+	request();
+	CHECK_BN(bn);
+	kbmap[bn] = key;
+	return 0;
+}
+
+int spnav_cfg_get_kbmap(int bn)
+{
+	request();
+	CHECK_BN(bn);
+	return kbmap[bn];
+}
+
+int spnav_cfg_set_swapyz(int swap)
+{
+	request();
+	swapyz = swap;
+	return 0;
+}
+
+int spnav_cfg_get_swapyz(void)
+{
+	request();
+	return swapyz;
+}
+
+int spnav_cfg_set_led(int mode)
+{
+	request();
+	led = mode;
+	return 0;
+}
+
+int spnav_cfg_get_led(void)
+{
+	request();
+	return led;
+}
+
+int spnav_cfg_set_grab(int g)
+{
+	request();
+	grab = g;
+	return 0;
+}
+
+int spnav_cfg_get_grab(void)
+{
+	request();
+	return grab;
+}
+
+int spnav_cfg_set_repeat(int msec)
+{
+	request();
+	repeat = msec;
+	return 0;
+}
+
+int spnav_cfg_get_repeat(void)
+{
+	request();
+	return repeat;
+}
+
+int spnav_cfg_set_serial(const char *devpath)
+{
+	request();
+	free(serdev);
+	serdev = devpath && *devpath ? strdup(devpath) : 0;
+	return 0;
+}
+
+int spnav_cfg_get_serial(char *buf, int bufsz)
+{
+	int len;
+
+	request();
+	if(!serdev) {
+		if(buf && bufsz > 0) *buf = 0;
+		return 0;
+	}
+	len = strlen(serdev);
+	if(buf && bufsz > 0) {
+		strncpy(buf, serdev, bufsz - 1);
+		buf[bufsz - 1] = 0;
+	}
+	return len;
+}
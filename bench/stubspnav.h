@@ -0,0 +1,52 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef STUBSPNAV_H_
+#define STUBSPNAV_H_
+
+#include <spnav.h>
+
+/* in-process stand-in for libspnav and spacenavd, for benchmarking. Events
+ * pushed with stub_push_event are delivered through a socketpair, so that the
+ * I/O thread and the select loop are exercised like with the real daemon.
+ * Every request to the "daemon" busy-waits for the configured latency.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* takes effect on the next spnav_open */
+void stub_set_device(int nbuttons, int naxes);
+void stub_set_latency(long usec);
+
+/* requests made so far (device info and configuration calls) */
+unsigned long stub_requests(void);
+
+/* returns -1 if the event queue is full */
+int stub_push_event(const spnav_event *ev);
+
+/* drops the connection and resets the configuration to the defaults, like a
+ * spacenavd restart. Clients may reconnect right away.
+ */
+void stub_restart(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* STUBSPNAV_H_ */
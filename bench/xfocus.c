@@ -0,0 +1,106 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include "xfocus.h"
+
+#ifdef USE_X11
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+
+static Display *dpy;
+static Window win;
+
+int xfocus_open(void)
+{
+	if(dpy) return 0;
+
+	if(!getenv("DISPLAY") || !(dpy = XOpenDisplay(0))) {
+		return -1;
+	}
+	return 0;
+}
+
+void xfocus_close(void)
+{
+	Window none = None;
+
+	if(!dpy) return;
+
+	XChangeProperty(dpy, DefaultRootWindow(dpy), XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False),
+			XA_WINDOW, 32, PropModeReplace, (unsigned char*)&none, 1);
+	if(win) {
+		XDestroyWindow(dpy, win);
+		win = 0;
+	}
+	XCloseDisplay(dpy);
+	dpy = 0;
+}
+
+int xfocus_set_class(const char *wmclass)
+{
+	XClassHint hint;
+
+	if(!dpy || !win) return -1;
+
+	hint.res_name = (char*)wmclass;
+	hint.res_class = (char*)wmclass;
+	XSetClassHint(dpy, win, &hint);
+	XSync(dpy, False);
+	return 0;
+}
+
+int xfocus_new_window(const char *wmclass)
+{
+	if(!dpy) return -1;
+
+	if(win) {
+		XDestroyWindow(dpy, win);
+	}
+	win = XCreateSimpleWindow(dpy, DefaultRootWindow(dpy), 0, 0, 16, 16, 0, 0, 0);
+	xfocus_set_class(wmclass);
+	XMapWindow(dpy, win);
+
+	XChangeProperty(dpy, DefaultRootWindow(dpy), XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False),
+			XA_WINDOW, 32, PropModeReplace, (unsigned char*)&win, 1);
+	XSync(dpy, False);
+	return 0;
+}
+
+#else	/* !USE_X11 */
+
+int xfocus_open(void)
+{
+	return -1;
+}
+
+void xfocus_close(void)
+{
+}
+
+int xfocus_new_window(const char *wmclass)
+{
+	return -1;
+}
+
+int xfocus_set_class(const char *wmclass)
+{
+	return -1;
+}
+
+#endif	/* USE_X11 */
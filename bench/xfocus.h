@@ -0,0 +1,44 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef XFOCUS_H_
+#define XFOCUS_H_
+
+/* stands in for a window manager, to check the application watcher: maps a
+ * window with a given WM_CLASS, and points _NET_ACTIVE_WINDOW on the root
+ * window at it. Runs against whatever X server DISPLAY names, meant to be
+ * Xvfb. Without X11 support, xfocus_open always fails.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns -1 if there is no X server to talk to */
+int xfocus_open(void);
+void xfocus_close(void);
+
+/* creates a window with this WM_CLASS, and makes it the active one */
+int xfocus_new_window(const char *wmclass);
+/* changes the WM_CLASS of the active window */
+int xfocus_set_class(const char *wmclass);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* XFOCUS_H_ */
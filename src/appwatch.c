@@ -0,0 +1,368 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include "appwatch.h"
+
+#ifdef USE_X11
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include "profile.h"
+
+struct rule {
+	char *wmclass, *profile;
+};
+
+static struct rule *rules;
+static int num_rules;
+static const char *fallback;
+
+static Display *dpy;
+static Atom xa_active_win;
+static Window active_win;
+static const char *cur_profile;
+
+static pthread_t thread;
+static int wakeup_pipe[2] = {-1, -1};
+static int quit_pipe[2] = {-1, -1};
+static int active;
+
+/* hand-off slot, filled by the watcher thread, emptied by appwatch_poll */
+static pthread_mutex_t pending_lock = PTHREAD_MUTEX_INITIALIZER;
+static int pending;
+static char pending_name[256];
+
+static int load_rules(void);
+static void free_rules(void);
+static void *watch_thread(void *arg);
+
+static int xerr_handler(Display *dpy, XErrorEvent *err)
+{
+	/* windows can go away while we're looking at them */
+	return 0;
+}
+
+int appwatch_start(void)
+{
+	if(active) return wakeup_pipe[0];
+
+	if(load_rules() == -1 || !num_rules) {
+		fprintf(stderr, "appwatch: no application rules defined\n");
+		free_rules();
+		return -1;
+	}
+
+	if(!(dpy = XOpenDisplay(0))) {
+		fprintf(stderr, "appwatch: failed to connect to the X server\n");
+		free_rules();
+		return -1;
+	}
+	XSetErrorHandler(xerr_handler);
+	xa_active_win = XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False);
+	XSelectInput(dpy, DefaultRootWindow(dpy), PropertyChangeMask);
+	XFlush(dpy);
+
+	if(pipe(wakeup_pipe) == -1 || pipe(quit_pipe) == -1) {
+		fprintf(stderr, "appwatch: failed to create pipe: %s\n", strerror(errno));
+		goto err;
+	}
+	fcntl(wakeup_pipe[0], F_SETFL, fcntl(wakeup_pipe[0], F_GETFL) | O_NONBLOCK);
+
+	active_win = 0;
+	cur_profile = 0;
+	if(pthread_create(&thread, 0, watch_thread, 0) != 0) {
+		fprintf(stderr, "appwatch: failed to start the watcher thread\n");
+		goto err;
+	}
+	active = 1;
+	return wakeup_pipe[0];
+
+err:
+	XCloseDisplay(dpy);
+	dpy = 0;
+	free_rules();
+	return -1;
+}
+
+void appwatch_stop(void)
+{
+	int i;
+
+	if(!active) return;
+
+	while(write(quit_pipe[1], "q", 1) == -1 && errno == EINTR);
+	pthread_join(thread, 0);
+
+	for(i=0; i<2; i++) {
+		close(wakeup_pipe[i]);
+		close(quit_pipe[i]);
+		wakeup_pipe[i] = quit_pipe[i] = -1;
+	}
+	XCloseDisplay(dpy);
+	dpy = 0;
+	free_rules();
+
+	pending = 0;
+	active = 0;
+}
+
+int appwatch_active(void)
+{
+	return active;
+}
+
+int appwatch_poll(char *name, int namesz)
+{
+	char buf[64];
+	int res = -1;
+
+	while(read(wakeup_pipe[0], buf, sizeof buf) > 0);
+
+	pthread_mutex_lock(&pending_lock);
+	if(pending) {
+		snprintf(name, namesz, "%s", pending_name);
+		pending = 0;
+		res = 0;
+	}
+	pthread_mutex_unlock(&pending_lock);
+	return res;
+}
+
+static char *strip(char *s)
+{
+	char *end;
+
+	while(*s && isspace((unsigned char)*s)) s++;
+	end = s + strlen(s);
+	while(end > s && isspace((unsigned char)end[-1])) end--;
+	*end = 0;
+	return s;
+}
+
+static int load_rules(void)
+{
+	char path[1024], line[512], *key, *val;
+	const char *base, *home;
+	FILE *fp;
+	struct rule *tmp;
+	int max = 0;
+
+	if((base = getenv("XDG_CONFIG_HOME")) && *base) {
+		snprintf(path, sizeof path, "%s/spnavcfg/apps.conf", base);
+	} else if((home = getenv("HOME")) && *home) {
+		snprintf(path, sizeof path, "%s/.config/spnavcfg/apps.conf", home);
+	} else {
+		return -1;
+	}
+	if(!(fp = fopen(path, "r"))) {
+		fprintf(stderr, "appwatch: failed to open %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	while(fgets(line, sizeof line, fp)) {
+		key = strip(line);
+		if(!*key || *key == '#') continue;
+
+		if(!(val = strchr(key, '='))) {
+			fprintf(stderr, "appwatch: ignoring invalid rule: %s\n", key);
+			continue;
+		}
+		*val++ = 0;
+		key = strip(key);
+		val = strip(val);
+		if(!*key || !profile_valid_name(val)) {
+			fprintf(stderr, "appwatch: ignoring invalid rule: %s = %s\n", key, val);
+			continue;
+		}
+
+		if(num_rules >= max) {
+			max = max ? max * 2 : 16;
+			if(!(tmp = realloc(rules, max * sizeof *rules))) break;
+			rules = tmp;
+		}
+		rules[num_rules].wmclass = strdup(key);
+		rules[num_rules].profile = strdup(val);
+		if(strcmp(key, "*") == 0) {
+			fallback = rules[num_rules].profile;
+		}
+		num_rules++;
+	}
+	fclose(fp);
+	return 0;
+}
+
+static void free_rules(void)
+{
+	int i;
+	for(i=0; i<num_rules; i++) {
+		free(rules[i].wmclass);
+		free(rules[i].profile);
+	}
+	free(rules);
+	rules = 0;
+	num_rules = 0;
+	fallback = 0;
+}
+
+static const char *match_profile(Window win)
+{
+	XClassHint hint;
+	const char *prof = fallback;
+	int i;
+
+	if(!win || !XGetClassHint(dpy, win, &hint)) {
+		return prof;
+	}
+	for(i=0; i<num_rules; i++) {
+		if(strcasecmp(rules[i].wmclass, hint.res_class) == 0 ||
+				strcasecmp(rules[i].wmclass, hint.res_name) == 0) {
+			prof = rules[i].profile;
+			break;
+		}
+	}
+	XFree(hint.res_name);
+	XFree(hint.res_class);
+	return prof;
+}
+
+static Window get_active_window(void)
+{
+	Atom type;
+	int fmt;
+	unsigned long count, rem;
+	unsigned char *data = 0;
+	Window win = 0;
+
+	if(XGetWindowProperty(dpy, DefaultRootWindow(dpy), xa_active_win, 0, 1, False,
+				XA_WINDOW, &type, &fmt, &count, &rem, &data) == Success && data) {
+		if(type == XA_WINDOW && fmt == 32 && count) {
+			win = *(Window*)data;
+		}
+		XFree(data);
+	}
+	return win;
+}
+
+/* the profile is loaded by the GUI thread, which owns the device info it's
+ * read against
+ */
+static void update_profile(void)
+{
+	const char *name;
+
+	if(!(name = match_profile(active_win)) || name == cur_profile) {
+		return;
+	}
+	cur_profile = name;
+
+	pthread_mutex_lock(&pending_lock);
+	pending = 1;
+	snprintf(pending_name, sizeof pending_name, "%s", name);
+	pthread_mutex_unlock(&pending_lock);
+
+	while(write(wakeup_pipe[1], "w", 1) == -1 && errno == EINTR);
+}
+
+/* toplevels mapped late can set or change WM_CLASS after taking the focus, so
+ * the focused window is watched for property changes as well. It's selected
+ * before matching, for a change in between not to be missed.
+ */
+static void focus_changed(void)
+{
+	Window win = get_active_window();
+
+	if(win != active_win) {
+		if(active_win) {
+			XSelectInput(dpy, active_win, NoEventMask);
+		}
+		if(win) {
+			XSelectInput(dpy, win, PropertyChangeMask);
+		}
+		active_win = win;
+	}
+	update_profile();
+}
+
+static void *watch_thread(void *arg)
+{
+	int xfd = ConnectionNumber(dpy);
+	int maxfd = xfd > quit_pipe[0] ? xfd : quit_pipe[0];
+	fd_set rdset;
+	XEvent xev;
+
+	focus_changed();
+
+	for(;;) {
+		while(XPending(dpy)) {
+			XNextEvent(dpy, &xev);
+			if(xev.type != PropertyNotify) continue;
+
+			if(xev.xproperty.window == DefaultRootWindow(dpy)) {
+				if(xev.xproperty.atom == xa_active_win) {
+					focus_changed();
+				}
+			} else if(xev.xproperty.window == active_win && xev.xproperty.atom == XA_WM_CLASS) {
+				update_profile();
+			}
+		}
+
+		FD_ZERO(&rdset);
+		FD_SET(xfd, &rdset);
+		FD_SET(quit_pipe[0], &rdset);
+		if(select(maxfd + 1, &rdset, 0, 0, 0) == -1 && errno != EINTR) {
+			break;
+		}
+		if(FD_ISSET(quit_pipe[0], &rdset)) {
+			break;
+		}
+	}
+	return 0;
+}
+
+#else	/* !USE_X11 */
+
+int appwatch_start(void)
+{
+	fprintf(stderr, "appwatch: spnavcfg was built without X11 support\n");
+	return -1;
+}
+
+void appwatch_stop(void)
+{
+}
+
+int appwatch_active(void)
+{
+	return 0;
+}
+
+int appwatch_poll(char *name, int namesz)
+{
+	return -1;
+}
+
+#endif	/* USE_X11 */
@@ -0,0 +1,55 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef APPWATCH_H_
+#define APPWATCH_H_
+
+#include "spnavcfg.h"
+
+/* per-application profile switching. A background thread follows the
+ * focused window through _NET_ACTIVE_WINDOW property notifications on the
+ * root window, and maps its WM_CLASS, re-read whenever it changes, to a
+ * profile through the rules in $XDG_CONFIG_HOME/spnavcfg/apps.conf. The GUI
+ * thread is woken up through a pipe, and loads the profile itself, against
+ * the device info it owns.
+ *
+ * apps.conf has one "wmclass = profile" rule per line, matched
+ * case-insensitively against either part of WM_CLASS, and an optional
+ * "* = profile" fallback for all other windows.
+ *
+ * Only available when built with X11 support (USE_X11).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns a file descriptor to watch for readability, or -1 on failure */
+int appwatch_start(void);
+void appwatch_stop(void);
+int appwatch_active(void);
+
+/* fetches the pending profile switch, if any. name receives the profile
+ * name. Returns -1 if there is nothing pending.
+ */
+int appwatch_poll(char *name, int namesz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* APPWATCH_H_ */
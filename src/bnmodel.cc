@@ -0,0 +1,380 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <QApplication>
+#include <QComboBox>
+#include <QCompleter>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QColor>
+#include <QStringListModel>
+#define SPNAV_CONFIG_H_
+#include <spnav.h>
+#include "bnmodel.h"
+#include "cfgwr.h"
+#include "keysym.h"
+#include "ui.h"
+
+static const char *mode_names[] = {"button", "action", "key"};
+
+static const char *action_names[] = {
+	"-",
+	"Sensitivity reset",
+	"Sensitivity increase",
+	"Sensitivity decrease",
+	"Disable rotation",
+	"Disable translation",
+	"Dominant axis"
+};
+#define NUM_ACTIONS	(int)(sizeof action_names / sizeof *action_names)
+
+static const char *common_keys[] = {
+	"Escape", "Return", "Delete", "BackSpace", "Tab", "Shift_L", "Control_L",
+	"Alt_L", "Super_L", "Meta_L"
+};
+#define NUM_COMMON_KEYS	(int)(sizeof common_keys / sizeof *common_keys)
+
+
+/* prefix completion over the whole keysym catalog. The name list is built once
+ * and shared by all key editors; it's already sorted, which lets QCompleter
+ * binary search it instead of filtering linearly.
+ */
+static QCompleter *keysym_completer(QObject *par)
+{
+	static QStringListModel *names;
+
+	if(!names) {
+		QStringList list;
+		int count = keysym_count();
+		list.reserve(count);
+		for(int i=0; i<count; i++) {
+			list << keysym_name_at(i);
+		}
+		names = new QStringListModel(list, qApp);
+	}
+
+	QCompleter *comp = new QCompleter(names, par);
+	comp->setModelSorting(QCompleter::CaseSensitivelySortedModel);
+	comp->setCaseSensitivity(Qt::CaseSensitive);
+	comp->setCompletionMode(QCompleter::PopupCompletion);
+	return comp;
+}
+
+BnMapModel::BnMapModel(QObject *par)
+	: QAbstractTableModel(par)
+{
+	nrows = 0;
+	memset(pressed, 0, sizeof pressed);
+	memset(last_act, 0, sizeof last_act);
+	memset(last_key, 0, sizeof last_key);
+}
+
+void BnMapModel::derive_mode(int row)
+{
+	if(cfg.kbmap[row] > 0) {
+		mode[row] = BNMODE_KEY;
+		last_key[row] = cfg.kbmap[row];
+	} else if(cfg.bnact[row]) {
+		mode[row] = BNMODE_ACTION;
+		last_act[row] = cfg.bnact[row];
+	} else {
+		mode[row] = BNMODE_BUTTON;
+	}
+}
+
+void BnMapModel::reset()
+{
+	beginResetModel();
+	nrows = devinfo.nbuttons;
+	for(int i=0; i<nrows; i++) {
+		derive_mode(i);
+	}
+	memset(pressed, 0, sizeof pressed);
+	endResetModel();
+}
+
+void BnMapModel::update(const struct config *prev)
+{
+	for(int i=0; i<nrows; i++) {
+		if(cfg.map_bn[i] != prev->map_bn[i] || cfg.bnact[i] != prev->bnact[i] ||
+				cfg.kbmap[i] != prev->kbmap[i]) {
+			derive_mode(i);
+			emit dataChanged(index(i, BNCOL_MODE), index(i, BNCOL_VALUE));
+		}
+	}
+}
+
+void BnMapModel::set_pressed(int bn, bool press)
+{
+	if(bn < 0 || bn >= nrows || (bool)pressed[bn] == press) return;
+
+	pressed[bn] = press;
+	QModelIndex idx = index(bn, BNCOL_INDEX);
+	emit dataChanged(idx, idx, QVector<int>() << Qt::ForegroundRole);
+}
+
+int BnMapModel::rowCount(const QModelIndex &par) const
+{
+	return par.isValid() ? 0 : nrows;
+}
+
+int BnMapModel::columnCount(const QModelIndex &par) const
+{
+	return par.isValid() ? 0 : BN_NUM_COLUMNS;
+}
+
+QVariant BnMapModel::data(const QModelIndex &idx, int role) const
+{
+	int row = idx.row();
+	const char *str;
+
+	if(!idx.isValid() || row >= nrows) {
+		return QVariant();
+	}
+
+	if(role == Qt::ForegroundRole) {
+		if(idx.column() == BNCOL_INDEX && pressed[row]) {
+			return QColor(Qt::red);
+		}
+		return QVariant();
+	}
+	if(role != Qt::DisplayRole && role != Qt::EditRole) {
+		return QVariant();
+	}
+
+	switch(idx.column()) {
+	case BNCOL_INDEX:
+		return QString::asprintf("%02d", row);
+
+	case BNCOL_MODE:
+		if(role == Qt::EditRole) return mode[row];
+		return mode_names[mode[row]];
+
+	case BNCOL_VALUE:
+		switch(mode[row]) {
+		case BNMODE_BUTTON:
+			return cfg.map_bn[row];
+
+		case BNMODE_ACTION:
+			if(role == Qt::EditRole) return cfg.bnact[row];
+			if(cfg.bnact[row] >= 0 && cfg.bnact[row] < NUM_ACTIONS) {
+				return action_names[cfg.bnact[row]];
+			}
+			return QString::number(cfg.bnact[row]);
+
+		case BNMODE_KEY:
+			if(cfg.kbmap[row] > 0 && (str = keysym_name(cfg.kbmap[row]))) {
+				return str;
+			}
+			return "-";
+		}
+		break;
+	}
+	return QVariant();
+}
+
+QVariant BnMapModel::headerData(int sect, Qt::Orientation orient, int role) const
+{
+	static const char *colnames[] = {"Button", "Mapping", "Value"};
+
+	if(role != Qt::DisplayRole || orient != Qt::Horizontal || sect < 0 || sect >= BN_NUM_COLUMNS) {
+		return QVariant();
+	}
+	return colnames[sect];
+}
+
+Qt::ItemFlags BnMapModel::flags(const QModelIndex &idx) const
+{
+	Qt::ItemFlags fl = QAbstractTableModel::flags(idx);
+	if(idx.column() != BNCOL_INDEX) {
+		fl |= Qt::ItemIsEditable;
+	}
+	return fl;
+}
+
+bool BnMapModel::setData(const QModelIndex &idx, const QVariant &val, int role)
+{
+	int row = idx.row();
+	int newmode, bn, act;
+	long sym;
+
+	if(!idx.isValid() || row >= nrows || role != Qt::EditRole) {
+		return false;
+	}
+
+	switch(idx.column()) {
+	case BNCOL_MODE:
+		newmode = val.toInt();
+		if(newmode < 0 || newmode > BNMODE_KEY) return false;
+		if(newmode == mode[row]) return true;
+
+		/* in spacenavd a bound key overrides an action, which overrides the
+		 * button mapping, so switching modes clears the other bindings, and
+		 * restores the last one the user picked for the new mode.
+		 */
+		if(cfg.bnact[row]) last_act[row] = cfg.bnact[row];
+		if(cfg.kbmap[row] > 0) last_key[row] = cfg.kbmap[row];
+		cfg.bnact[row] = newmode == BNMODE_ACTION ? last_act[row] : SPNAV_BNACT_NONE;
+		cfg.kbmap[row] = newmode == BNMODE_KEY ? last_key[row] : 0;
+		mode[row] = newmode;
+		mark_shown(CFG_BNACT | CFG_KBMAP);
+		cfgwr_touch(CFG_BNACT | CFG_KBMAP);
+		break;
+
+	case BNCOL_VALUE:
+		switch(mode[row]) {
+		case BNMODE_BUTTON:
+			bn = val.toInt();
+			if(bn < 0 || bn >= nrows) return false;
+			cfg.map_bn[row] = bn;
+			mark_shown(CFG_BNMAP);
+			cfgwr_touch(CFG_BNMAP);
+			break;
+
+		case BNMODE_ACTION:
+			act = val.toInt();
+			if(act < 0 || act >= NUM_ACTIONS) return false;
+			cfg.bnact[row] = last_act[row] = act;
+			mark_shown(CFG_BNACT);
+			cfgwr_touch(CFG_BNACT);
+			break;
+
+		case BNMODE_KEY:
+			sym = keysym_lookup(val.toString().toLatin1().data());
+			if(!sym) return false;
+			cfg.kbmap[row] = last_key[row] = sym;
+			mark_shown(CFG_KBMAP);
+			cfgwr_touch(CFG_KBMAP);
+			break;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	emit dataChanged(index(row, BNCOL_MODE), index(row, BNCOL_VALUE));
+	return true;
+}
+
+
+BnMapDelegate::BnMapDelegate(QObject *par)
+	: QStyledItemDelegate(par)
+{
+}
+
+QWidget *BnMapDelegate::createEditor(QWidget *par, const QStyleOptionViewItem &opt,
+		const QModelIndex &idx) const
+{
+	QComboBox *cmb;
+	QSpinBox *spin;
+	const BnMapModel *model = (const BnMapModel*)idx.model();
+
+	/* commit on every change, like the old per-row widgets did */
+	switch(idx.column()) {
+	case BNCOL_MODE:
+		cmb = new QComboBox(par);
+		for(int i=0; i<3; i++) {
+			cmb->addItem(mode_names[i]);
+		}
+		connect(cmb, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+				this, [this, cmb]() { emit const_cast<BnMapDelegate*>(this)->commitData(cmb); });
+		return cmb;
+
+	case BNCOL_VALUE:
+		switch(model->row_mode(idx.row())) {
+		case BNMODE_BUTTON:
+			spin = new QSpinBox(par);
+			spin->setRange(0, model->rowCount() - 1);
+			connect(spin, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+					this, [this, spin]() { emit const_cast<BnMapDelegate*>(this)->commitData(spin); });
+			return spin;
+
+		case BNMODE_ACTION:
+			cmb = new QComboBox(par);
+			for(int i=0; i<NUM_ACTIONS; i++) {
+				cmb->addItem(action_names[i]);
+			}
+			connect(cmb, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+					this, [this, cmb]() { emit const_cast<BnMapDelegate*>(this)->commitData(cmb); });
+			return cmb;
+
+		case BNMODE_KEY:
+			cmb = new QComboBox(par);
+			cmb->setEditable(true);
+			cmb->setCompleter(keysym_completer(cmb));
+			for(int i=0; i<NUM_COMMON_KEYS; i++) {
+				cmb->addItem(common_keys[i]);
+			}
+			connect(cmb, &QComboBox::currentTextChanged, this, [this, cmb](const QString &qstr) {
+				/* commit only valid key names, and flag text which can't be
+				 * completed to any key name in red
+				 */
+				QByteArray name = qstr.toLatin1();
+				QLineEdit *ed = cmb->lineEdit();
+				QPalette cmap = cmb->palette();
+				if(!keysym_lookup(name.data())) {
+					if(!keysym_prefix_range(name.data(), 0)) {
+						cmap.setColor(QPalette::Text, Qt::red);
+					}
+					ed->setPalette(cmap);
+					return;
+				}
+				ed->setPalette(cmap);
+				emit const_cast<BnMapDelegate*>(this)->commitData(cmb);
+			});
+			return cmb;
+		}
+		break;
+	}
+	return QStyledItemDelegate::createEditor(par, opt, idx);
+}
+
+void BnMapDelegate::setEditorData(QWidget *ed, const QModelIndex &idx) const
+{
+	QVariant val = idx.data(Qt::EditRole);
+
+	if(QSpinBox *spin = qobject_cast<QSpinBox*>(ed)) {
+		QSignalBlocker block(spin);
+		spin->setValue(val.toInt());
+	} else if(QComboBox *cmb = qobject_cast<QComboBox*>(ed)) {
+		QSignalBlocker block(cmb);
+		if(cmb->isEditable()) {
+			cmb->setCurrentText(val.toString());
+		} else {
+			cmb->setCurrentIndex(val.toInt());
+		}
+	} else {
+		QStyledItemDelegate::setEditorData(ed, idx);
+	}
+}
+
+void BnMapDelegate::setModelData(QWidget *ed, QAbstractItemModel *model, const QModelIndex &idx) const
+{
+	if(QSpinBox *spin = qobject_cast<QSpinBox*>(ed)) {
+		model->setData(idx, spin->value());
+	} else if(QComboBox *cmb = qobject_cast<QComboBox*>(ed)) {
+		if(cmb->isEditable()) {
+			model->setData(idx, cmb->currentText());
+		} else {
+			model->setData(idx, cmb->currentIndex());
+		}
+	} else {
+		QStyledItemDelegate::setModelData(ed, model, idx);
+	}
+}
@@ -0,0 +1,72 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BNMODEL_H_
+#define BNMODEL_H_
+
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include "spnavcfg.h"
+
+enum { BNMODE_BUTTON, BNMODE_ACTION, BNMODE_KEY };
+enum { BNCOL_INDEX, BNCOL_MODE, BNCOL_VALUE, BN_NUM_COLUMNS };
+
+/* table model over the button mapping part of the global cfg. Each row is a
+ * device button, and the mode column selects whether it's remapped to another
+ * button, bound to an action, or bound to a key.
+ */
+class BnMapModel : public QAbstractTableModel {
+private:
+	int nrows;
+	int mode[MAX_BUTTONS];
+	/* last action/key of each row, restored when switching modes back */
+	int last_act[MAX_BUTTONS], last_key[MAX_BUTTONS];
+	unsigned char pressed[MAX_BUTTONS];
+
+	void derive_mode(int row);
+
+public:
+	explicit BnMapModel(QObject *par = 0);
+
+	/* call after devinfo.nbuttons changes, resets the whole model */
+	void reset();
+	/* call after cfg changes, emits dataChanged for rows differing from prev */
+	void update(const struct config *prev);
+	void set_pressed(int bn, bool press);
+
+	int row_mode(int row) const { return mode[row]; }
+
+	int rowCount(const QModelIndex &par = QModelIndex()) const;
+	int columnCount(const QModelIndex &par = QModelIndex()) const;
+	QVariant data(const QModelIndex &idx, int role = Qt::DisplayRole) const;
+	QVariant headerData(int sect, Qt::Orientation orient, int role = Qt::DisplayRole) const;
+	Qt::ItemFlags flags(const QModelIndex &idx) const;
+	bool setData(const QModelIndex &idx, const QVariant &val, int role = Qt::EditRole);
+};
+
+/* creates mode and value editors on demand, only for the cell being edited */
+class BnMapDelegate : public QStyledItemDelegate {
+public:
+	explicit BnMapDelegate(QObject *par = 0);
+
+	QWidget *createEditor(QWidget *par, const QStyleOptionViewItem &opt,
+			const QModelIndex &idx) const;
+	void setEditorData(QWidget *ed, const QModelIndex &idx) const;
+	void setModelData(QWidget *ed, QAbstractItemModel *model, const QModelIndex &idx) const;
+};
+
+#endif	/* BNMODEL_H_ */
@@ -0,0 +1,64 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <math.h>
+#include "calib.h"
+
+void calib_begin(struct calib_stats *cs, int naxes)
+{
+	memset(cs, 0, sizeof *cs);
+	cs->naxes = naxes > MAX_AXES ? MAX_AXES : naxes;
+}
+
+void calib_sample(struct calib_stats *cs, const int *val)
+{
+	int i, n = cs->naxes;
+	double rcount;
+	double *mean = cs->mean;
+	double *m2 = cs->m2;
+	int *peak = cs->peak;
+
+	rcount = 1.0 / (double)++cs->count;
+
+	for(i=0; i<n; i++) {
+		double x = val[i];
+		double d = x - mean[i];
+		int absval = val[i] < 0 ? -val[i] : val[i];
+
+		mean[i] += d * rcount;
+		m2[i] += d * (x - mean[i]);
+		peak[i] = absval > peak[i] ? absval : peak[i];
+	}
+}
+
+double calib_stddev(const struct calib_stats *cs, int axis)
+{
+	if(cs->count < 2) return 0.0;
+	return sqrt(cs->m2[axis] / (double)(cs->count - 1));
+}
+
+int calib_deadzone(const struct calib_stats *cs, int axis)
+{
+	double bound = fabs(cs->mean[axis]) + CALIB_SIGMA * calib_stddev(cs, axis);
+	int dz = (int)ceil(bound);
+
+	if(cs->peak[axis] > dz) dz = cs->peak[axis];
+	dz++;
+
+	return dz > CALIB_MAX_DEADZONE ? CALIB_MAX_DEADZONE : dz;
+}
@@ -0,0 +1,58 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include "spnavcfg.h"
+
+/* streaming rest-noise statistics over all device axes. Every sample is a
+ * full vector of raw axis values; the running mean and variance (Welford) and
+ * the peak absolute value are kept as separate arrays, so that the update is
+ * one straight loop over the axes.
+ */
+struct calib_stats {
+	int naxes;
+	unsigned long count;
+	double mean[MAX_AXES];
+	double m2[MAX_AXES];
+	int peak[MAX_AXES];
+};
+
+/* recording time, and the margin added to the measured noise */
+#define CALIB_MSEC			3000
+#define CALIB_SIGMA			4.0
+#define CALIB_MAX_DEADZONE	255
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void calib_begin(struct calib_stats *cs, int naxes);
+void calib_sample(struct calib_stats *cs, const int *val);
+
+double calib_stddev(const struct calib_stats *cs, int axis);
+/* proposed deadzone: just past the larger of the observed peak and
+ * |mean| + CALIB_SIGMA standard deviations
+ */
+int calib_deadzone(const struct calib_stats *cs, int axis);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CALIB_H_ */
@@ -0,0 +1,259 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "cfgcache.h"
+#include "cfgtext.h"
+
+#define CACHE_LAST		"last"
+#define CACHE_SUFFIX	".conf"
+
+static int cache_dir(char *buf, int bufsz, int create)
+{
+	const char *base, *home;
+	int len;
+
+	if((base = getenv("XDG_CACHE_HOME")) && *base) {
+		len = snprintf(buf, bufsz, "%s/spnavcfg", base);
+	} else if((home = getenv("HOME")) && *home) {
+		len = snprintf(buf, bufsz, "%s/.cache/spnavcfg", home);
+	} else {
+		return -1;
+	}
+	if(len >= bufsz) return -1;
+
+	if(create && mkdir(buf, 0755) == -1 && errno != EEXIST) {
+		if(errno != ENOENT) return -1;
+		/* missing ~/.cache */
+		*strrchr(buf, '/') = 0;
+		mkdir(buf, 0755);
+		buf[strlen(buf)] = '/';
+		if(mkdir(buf, 0755) == -1 && errno != EEXIST) {
+			fprintf(stderr, "failed to create cache directory %s: %s\n", buf, strerror(errno));
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int streq(const char *a, const char *b)
+{
+	if(!a || !b) return a == b;
+	return strcmp(a, b) == 0;
+}
+
+/* FNV-1a of the device name, path and type */
+static unsigned long long device_key(const struct device_info *inf)
+{
+	unsigned long long key = 0xcbf29ce484222325ULL;
+	char type[16];
+	const char *str[3];
+	const unsigned char *s;
+	int i;
+
+	sprintf(type, "%d", inf->type);
+	str[0] = inf->name ? inf->name : "";
+	str[1] = inf->path ? inf->path : "";
+	str[2] = type;
+
+	for(i=0; i<3; i++) {
+		s = (const unsigned char*)str[i];
+		do {
+			key = (key ^ *s) * 0x100000001b3ULL;
+		} while(*s++);
+	}
+	return key;
+}
+
+static char *strip(char *s)
+{
+	char *end;
+
+	while(*s == ' ' || *s == '\t') s++;
+	end = s + strlen(s);
+	while(end > s && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+		*--end = 0;
+	}
+	return s;
+}
+
+/* reads the device.* lines at the start of an entry, leaving fp at the first
+ * configuration line
+ */
+static int read_device(FILE *fp, struct device_info *inf)
+{
+	char buf[512], *line, *val;
+	long pos;
+
+	for(;;) {
+		pos = ftell(fp);
+		if(!fgets(buf, sizeof buf, fp)) break;
+		line = strip(buf);
+		if(!*line || *line == '#') continue;
+
+		if(memcmp(line, "device.", 7) != 0 || !(val = strchr(line, '='))) {
+			fseek(fp, pos, SEEK_SET);
+			break;
+		}
+		*val++ = 0;
+		line = strip(line + 7);
+		val = strip(val);
+
+		if(strcmp(line, "name") == 0) {
+			free(inf->name);
+			inf->name = strdup(val);
+		} else if(strcmp(line, "path") == 0) {
+			free(inf->path);
+			inf->path = strdup(val);
+		} else if(strcmp(line, "type") == 0) {
+			inf->type = atoi(val);
+		} else if(strcmp(line, "axes") == 0) {
+			inf->naxes = atoi(val);
+		} else if(strcmp(line, "buttons") == 0) {
+			inf->nbuttons = atoi(val);
+		} else {
+			return -1;
+		}
+	}
+
+	if(inf->naxes <= 0 || inf->naxes > MAX_AXES || inf->nbuttons < 0 ||
+			inf->nbuttons > MAX_BUTTONS) {
+		return -1;
+	}
+	return 0;
+}
+
+int cache_load(struct config *cfg, struct device_info *inf)
+{
+	char path[1100], dir[1024], keystr[32];
+	FILE *fp;
+	unsigned long long key;
+	struct device_info dev = {0};
+	struct config newcfg = {0};
+	int res;
+
+	if(cache_dir(dir, sizeof dir, 0) == -1) {
+		return -1;
+	}
+
+	snprintf(path, sizeof path, "%s/" CACHE_LAST, dir);
+	if(!(fp = fopen(path, "r"))) {
+		return -1;
+	}
+	res = fgets(keystr, sizeof keystr, fp) ? 0 : -1;
+	fclose(fp);
+	if(res == -1) return -1;
+	key = strtoull(keystr, 0, 16);
+
+	snprintf(path, sizeof path, "%s/%016llx" CACHE_SUFFIX, dir, key);
+	if(!(fp = fopen(path, "r"))) {
+		return -1;
+	}
+	default_cfg(&newcfg);
+	if((res = read_device(fp, &dev)) != -1) {
+		res = cfg_read(fp, &newcfg, &dev);
+	}
+	fclose(fp);
+
+	/* a hand-edited or damaged entry might not belong to the key any more */
+	if(res == -1 || device_key(&dev) != key) {
+		fprintf(stderr, "ignoring invalid cache entry: %s\n", path);
+		free(dev.name);
+		free(dev.path);
+		free(newcfg.serdev);
+		return -1;
+	}
+
+	free(inf->name);
+	free(inf->path);
+	*inf = dev;
+	copy_cfg(cfg, &newcfg);
+	free(newcfg.serdev);
+	return 0;
+}
+
+/* written to a temporary file first and renamed over, so that a crash while
+ * writing never leaves a truncated file behind
+ */
+static FILE *open_tmp(const char *path, char *tmp, int tmpsz)
+{
+	FILE *fp;
+
+	if(snprintf(tmp, tmpsz, "%s.tmp", path) >= tmpsz) {
+		return 0;
+	}
+	if(!(fp = fopen(tmp, "w"))) {
+		fprintf(stderr, "failed to write cache file %s: %s\n", tmp, strerror(errno));
+	}
+	return fp;
+}
+
+static int commit_tmp(FILE *fp, const char *tmp, const char *path, int res)
+{
+	if(fclose(fp) == -1) res = -1;
+
+	if(res == -1 || rename(tmp, path) == -1) {
+		remove(tmp);
+		return -1;
+	}
+	return 0;
+}
+
+int cache_save(const struct config *cfg, const struct device_info *inf)
+{
+	char path[1100], tmp[1200], dir[1024];
+	FILE *fp;
+	unsigned long long key;
+	int res;
+
+	if(cache_dir(dir, sizeof dir, 1) == -1) {
+		return -1;
+	}
+	key = device_key(inf);
+
+	snprintf(path, sizeof path, "%s/%016llx" CACHE_SUFFIX, dir, key);
+	if(!(fp = open_tmp(path, tmp, sizeof tmp))) {
+		return -1;
+	}
+	fprintf(fp, "# spnavcfg cache, last known state of the device\n");
+	if(inf->name) fprintf(fp, "device.name = %s\n", inf->name);
+	if(inf->path) fprintf(fp, "device.path = %s\n", inf->path);
+	fprintf(fp, "device.type = %d\n", inf->type);
+	fprintf(fp, "device.axes = %d\n", inf->naxes);
+	fprintf(fp, "device.buttons = %d\n", inf->nbuttons);
+	res = cfg_write(fp, cfg, inf);
+	if(commit_tmp(fp, tmp, path, res) == -1) {
+		return -1;
+	}
+
+	snprintf(path, sizeof path, "%s/" CACHE_LAST, dir);
+	if(!(fp = open_tmp(path, tmp, sizeof tmp))) {
+		return -1;
+	}
+	fprintf(fp, "%016llx\n", key);
+	return commit_tmp(fp, tmp, path, 0);
+}
+
+int cache_same_device(const struct device_info *a, const struct device_info *b)
+{
+	return a->type == b->type && a->naxes == b->naxes && a->nbuttons == b->nbuttons &&
+		streq(a->name, b->name) && streq(a->path, b->path);
+}
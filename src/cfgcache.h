@@ -0,0 +1,50 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CFGCACHE_H_
+#define CFGCACHE_H_
+
+#include "spnavcfg.h"
+
+/* last known device info and configuration of each device, used to paint the
+ * window at startup without waiting for spacenavd. Stored one file per device
+ * in the cfgtext format, under $XDG_CACHE_HOME/spnavcfg/<key>.conf, where the
+ * key is a hash of the device name, path and type. The file "last" holds the
+ * key of the most recently used device.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* loads the entry of the most recently used device, returns -1 if there is
+ * none or it's unusable, in which case cfg and inf are left untouched
+ */
+int cache_load(struct config *cfg, struct device_info *inf);
+/* replaces the entry of the device and makes it the most recently used */
+int cache_save(const struct config *cfg, const struct device_info *inf);
+
+/* non-zero if both refer to the same device, with the same number of axes and
+ * buttons
+ */
+int cache_same_device(const struct device_info *a, const struct device_info *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CFGCACHE_H_ */
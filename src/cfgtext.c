@@ -0,0 +1,386 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "cfgtext.h"
+#include "keysym.h"
+
+enum { IDX_NONE, IDX_AXIS, IDX_DEVAXIS, IDX_BUTTON };
+
+enum {
+	KEY_SENS, KEY_SENS_AXIS, KEY_INVERT, KEY_SWAPYZ, KEY_AXISMAP, KEY_DEADZONE,
+	KEY_BNMAP, KEY_BNACT, KEY_KBMAP, KEY_LED, KEY_GRAB, KEY_REPEAT, KEY_SERIAL,
+
+	NUM_KEYS
+};
+
+static const struct {
+	const char *name;
+	int idxtype;
+	unsigned int flag;
+} keys[NUM_KEYS] = {
+	{"sens",		IDX_NONE,		CFG_SENS},
+	{"sens",		IDX_AXIS,		CFG_SENS_AXIS},
+	{"invert",		IDX_AXIS,		CFG_INVERT},
+	{"swapyz",		IDX_NONE,		CFG_SWAPYZ},
+	{"axismap",		IDX_DEVAXIS,	CFG_AXISMAP},
+	{"deadzone",	IDX_DEVAXIS,	CFG_DEADZONE},
+	{"bnmap",		IDX_BUTTON,		CFG_BNMAP},
+	{"bnaction",	IDX_BUTTON,		CFG_BNACT},
+	{"kbmap",		IDX_BUTTON,		CFG_KBMAP},
+	{"led",			IDX_NONE,		CFG_LED},
+	{"grab",		IDX_NONE,		CFG_GRAB},
+	{"repeat",		IDX_NONE,		CFG_REPEAT},
+	{"serial",		IDX_NONE,		CFG_SERIAL}
+};
+
+static const char *axis_names[] = {"tx", "ty", "tz", "rx", "ry", "rz"};
+static const char *bnact_names[] = {
+	"none", "sens-reset", "sens-inc", "sens-dec", "disable-rotation",
+	"disable-translation", "dominant-axis"
+};
+#define NUM_BNACT	(int)(sizeof bnact_names / sizeof *bnact_names)
+
+static const char *led_names[] = {"off", "on", "auto"};
+#define NUM_LED		(int)(sizeof led_names / sizeof *led_names)
+
+
+static int parse_key(const char *key, const struct device_info *inf, int *idx)
+{
+	int i, len, idxtype, max;
+	const char *dot;
+	char *endp;
+
+	if((dot = strchr(key, '.'))) {
+		len = dot - key;
+	} else {
+		len = strlen(key);
+	}
+
+	for(i=0; i<NUM_KEYS; i++) {
+		if(strlen(keys[i].name) != (size_t)len || memcmp(keys[i].name, key, len) != 0) {
+			continue;
+		}
+		if((idxtype = keys[i].idxtype) == IDX_NONE) {
+			if(dot) continue;
+			*idx = 0;
+			return i;
+		}
+		if(!dot) continue;
+
+		if(idxtype == IDX_AXIS) {
+			for(*idx=0; *idx<6; (*idx)++) {
+				if(strcmp(dot + 1, axis_names[*idx]) == 0) {
+					return i;
+				}
+			}
+			return -1;
+		}
+
+		max = idxtype == IDX_DEVAXIS ? inf->naxes : inf->nbuttons;
+		*idx = strtol(dot + 1, &endp, 10);
+		if(endp == dot + 1 || *endp || *idx < 0 || *idx >= max) {
+			return -1;
+		}
+		return i;
+	}
+	return -1;
+}
+
+static int parse_int(const char *str, int *res)
+{
+	char *endp;
+	long val = strtol(str, &endp, 10);
+	if(endp == str || *endp) return -1;
+	*res = val;
+	return 0;
+}
+
+static int parse_bool(const char *str, int *res)
+{
+	if(strcmp(str, "true") == 0 || strcmp(str, "yes") == 0 || strcmp(str, "on") == 0) {
+		*res = 1;
+		return 0;
+	}
+	if(strcmp(str, "false") == 0 || strcmp(str, "no") == 0 || strcmp(str, "off") == 0) {
+		*res = 0;
+		return 0;
+	}
+	if(parse_int(str, res) == -1) return -1;
+	*res = *res != 0;
+	return 0;
+}
+
+static int parse_name(const char *str, const char **names, int count, int *res)
+{
+	int i;
+	for(i=0; i<count; i++) {
+		if(strcmp(str, names[i]) == 0) {
+			*res = i;
+			return 0;
+		}
+	}
+	if(parse_int(str, res) == -1 || *res < 0 || *res >= count) {
+		return -1;
+	}
+	return 0;
+}
+
+int cfg_set_key(struct config *cfg, const struct device_info *inf, const char *key, const char *val)
+{
+	int k, idx, ival;
+	float fval;
+	long sym;
+	char *endp;
+
+	if((k = parse_key(key, inf, &idx)) == -1) {
+		return -1;
+	}
+
+	switch(k) {
+	case KEY_SENS:
+	case KEY_SENS_AXIS:
+		fval = strtod(val, &endp);
+		if(endp == val || *endp || fval <= 0.0f) return -1;
+		if(k == KEY_SENS) {
+			cfg->sens = fval;
+		} else {
+			cfg->sens_axis[idx] = fval;
+		}
+		break;
+
+	case KEY_INVERT:
+		if(parse_bool(val, &ival) == -1) return -1;
+		if(ival) {
+			cfg->invert |= 1 << idx;
+		} else {
+			cfg->invert &= ~(1 << idx);
+		}
+		break;
+
+	case KEY_SWAPYZ:
+		if(parse_bool(val, &cfg->swapyz) == -1) return -1;
+		break;
+
+	case KEY_AXISMAP:
+		if(strcmp(val, "none") == 0) {
+			ival = -1;
+		} else if(parse_name(val, axis_names, 6, &ival) == -1) {
+			return -1;
+		}
+		cfg->map_axis[idx] = ival;
+		break;
+
+	case KEY_DEADZONE:
+		if(parse_int(val, &ival) == -1 || ival < 0) return -1;
+		cfg->dead_thres[idx] = ival;
+		break;
+
+	case KEY_BNMAP:
+		if(parse_int(val, &ival) == -1 || ival < 0 || ival >= inf->nbuttons) return -1;
+		cfg->map_bn[idx] = ival;
+		break;
+
+	case KEY_BNACT:
+		if(parse_name(val, bnact_names, NUM_BNACT, &cfg->bnact[idx]) == -1) return -1;
+		break;
+
+	case KEY_KBMAP:
+		if(strcmp(val, "none") == 0) {
+			sym = 0;
+		} else if(!(sym = keysym_lookup(val))) {
+			return -1;
+		}
+		cfg->kbmap[idx] = sym;
+		break;
+
+	case KEY_LED:
+		if(parse_name(val, led_names, NUM_LED, &cfg->led) == -1) return -1;
+		break;
+
+	case KEY_GRAB:
+		if(parse_bool(val, &cfg->grab) == -1) return -1;
+		break;
+
+	case KEY_REPEAT:
+		if(strcmp(val, "off") == 0) {
+			cfg->repeat = -1;
+		} else if(parse_int(val, &cfg->repeat) == -1) {
+			return -1;
+		}
+		break;
+
+	case KEY_SERIAL:
+		free(cfg->serdev);
+		cfg->serdev = *val ? strdup(val) : 0;
+		break;
+	}
+
+	return keys[k].flag;
+}
+
+static void format_value(const struct config *cfg, int k, int idx, char *buf, int bufsz)
+{
+	const char *str;
+
+	switch(k) {
+	case KEY_SENS:
+		snprintf(buf, bufsz, "%g", cfg->sens);
+		break;
+	case KEY_SENS_AXIS:
+		snprintf(buf, bufsz, "%g", cfg->sens_axis[idx]);
+		break;
+	case KEY_INVERT:
+		snprintf(buf, bufsz, "%d", (cfg->invert >> idx) & 1);
+		break;
+	case KEY_SWAPYZ:
+		snprintf(buf, bufsz, "%d", cfg->swapyz);
+		break;
+	case KEY_AXISMAP:
+		if(cfg->map_axis[idx] >= 0 && cfg->map_axis[idx] < 6) {
+			snprintf(buf, bufsz, "%s", axis_names[cfg->map_axis[idx]]);
+		} else {
+			snprintf(buf, bufsz, "none");
+		}
+		break;
+	case KEY_DEADZONE:
+		snprintf(buf, bufsz, "%d", cfg->dead_thres[idx]);
+		break;
+	case KEY_BNMAP:
+		snprintf(buf, bufsz, "%d", cfg->map_bn[idx]);
+		break;
+	case KEY_BNACT:
+		if(cfg->bnact[idx] >= 0 && cfg->bnact[idx] < NUM_BNACT) {
+			snprintf(buf, bufsz, "%s", bnact_names[cfg->bnact[idx]]);
+		} else {
+			snprintf(buf, bufsz, "%d", cfg->bnact[idx]);
+		}
+		break;
+	case KEY_KBMAP:
+		if(cfg->kbmap[idx] <= 0) {
+			snprintf(buf, bufsz, "none");
+		} else if((str = keysym_name(cfg->kbmap[idx]))) {
+			snprintf(buf, bufsz, "%s", str);
+		} else {
+			snprintf(buf, bufsz, "0x%x", (unsigned int)cfg->kbmap[idx]);
+		}
+		break;
+	case KEY_LED:
+		if(cfg->led >= 0 && cfg->led < NUM_LED) {
+			snprintf(buf, bufsz, "%s", led_names[cfg->led]);
+		} else {
+			snprintf(buf, bufsz, "%d", cfg->led);
+		}
+		break;
+	case KEY_GRAB:
+		snprintf(buf, bufsz, "%d", cfg->grab);
+		break;
+	case KEY_REPEAT:
+		if(cfg->repeat < 0) {
+			snprintf(buf, bufsz, "off");
+		} else {
+			snprintf(buf, bufsz, "%d", cfg->repeat);
+		}
+		break;
+	case KEY_SERIAL:
+		snprintf(buf, bufsz, "%s", cfg->serdev ? cfg->serdev : "");
+		break;
+	}
+}
+
+int cfg_get_key(const struct config *cfg, const struct device_info *inf, const char *key,
+		char *buf, int bufsz)
+{
+	int k, idx;
+
+	if((k = parse_key(key, inf, &idx)) == -1) {
+		return -1;
+	}
+	format_value(cfg, k, idx, buf, bufsz);
+	return 0;
+}
+
+int cfg_write(FILE *fp, const struct config *cfg, const struct device_info *inf)
+{
+	int i, j, count;
+	char buf[512];
+
+	for(i=0; i<NUM_KEYS; i++) {
+		switch(keys[i].idxtype) {
+		case IDX_NONE:
+			format_value(cfg, i, 0, buf, sizeof buf);
+			fprintf(fp, "%s = %s\n", keys[i].name, buf);
+			break;
+
+		case IDX_AXIS:
+			for(j=0; j<6; j++) {
+				format_value(cfg, i, j, buf, sizeof buf);
+				fprintf(fp, "%s.%s = %s\n", keys[i].name, axis_names[j], buf);
+			}
+			break;
+
+		default:
+			count = keys[i].idxtype == IDX_DEVAXIS ? inf->naxes : inf->nbuttons;
+			for(j=0; j<count; j++) {
+				format_value(cfg, i, j, buf, sizeof buf);
+				fprintf(fp, "%s.%d = %s\n", keys[i].name, j, buf);
+			}
+		}
+	}
+	return ferror(fp) ? -1 : 0;
+}
+
+static char *strip(char *s)
+{
+	char *end;
+
+	while(*s && isspace((unsigned char)*s)) s++;
+	end = s + strlen(s);
+	while(end > s && isspace((unsigned char)end[-1])) end--;
+	*end = 0;
+	return s;
+}
+
+int cfg_read(FILE *fp, struct config *cfg, const struct device_info *inf)
+{
+	int res, lineno = 0;
+	unsigned int fields = 0;
+	char buf[512], *line, *key, *val;
+
+	while(fgets(buf, sizeof buf, fp)) {
+		lineno++;
+		line = strip(buf);
+		if(!*line || *line == '#') continue;
+
+		if(!(val = strchr(line, '='))) {
+			fprintf(stderr, "line %d: expected key = value\n", lineno);
+			return -1;
+		}
+		*val++ = 0;
+		key = strip(line);
+		val = strip(val);
+
+		if((res = cfg_set_key(cfg, inf, key, val)) == -1) {
+			fprintf(stderr, "line %d: invalid setting: %s = %s\n", lineno, key, val);
+			return -1;
+		}
+		fields |= res;
+	}
+	return fields;
+}
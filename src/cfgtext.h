@@ -0,0 +1,52 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CFGTEXT_H_
+#define CFGTEXT_H_
+
+#include <stdio.h>
+#include "spnavcfg.h"
+
+/* text representation of struct config, one "key = value" pair per line:
+ *   sens, sens.<axis>, invert.<axis>   (axis: tx, ty, tz, rx, ry, rz)
+ *   axismap.<n>, deadzone.<n>          (n: device axis)
+ *   bnmap.<n>, bnaction.<n>, kbmap.<n> (n: device button)
+ *   swapyz, led, grab, repeat, serial
+ * Lines starting with # are comments. Indices are checked against the device
+ * info passed in.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int cfg_write(FILE *fp, const struct config *cfg, const struct device_info *inf);
+/* applies all settings in the file on top of cfg. Returns the CFG_* flags of
+ * the fields which were set, or -1 on error.
+ */
+int cfg_read(FILE *fp, struct config *cfg, const struct device_info *inf);
+
+/* returns the CFG_* flag of the field set, or -1 on error */
+int cfg_set_key(struct config *cfg, const struct device_info *inf, const char *key, const char *val);
+int cfg_get_key(const struct config *cfg, const struct device_info *inf, const char *key,
+		char *buf, int bufsz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CFGTEXT_H_ */
@@ -0,0 +1,79 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "spnavcfg.h"
+#include "cfgwr.h"
+#include "ui.h"
+#include "undo.h"
+#include "spnavio.h"
+
+static struct config sent;
+static unsigned int dirty;
+static struct cfgwr_stats stats;
+
+void cfgwr_sync(const struct config *cur)
+{
+	copy_cfg(&sent, cur);
+	dirty = 0;
+}
+
+void cfgwr_touch(unsigned int fields)
+{
+	stats.edits++;
+	if(dirty & fields) {
+		stats.coalesced++;
+	}
+	if(!dirty) {
+		schedule_cfg_flush();
+	}
+	dirty |= fields;
+}
+
+int cfgwr_pending(void)
+{
+	return dirty != 0;
+}
+
+int cfgwr_flush(void)
+{
+	int count;
+
+	if(!dirty) return 0;
+
+	count = count_cfg_diff(&sent, &cfg, dirty, &devinfo);
+	if(count && spnavio_running() && spnavio_send_diff(&sent, &cfg, dirty) == -1) {
+		/* the I/O thread is stuck, keep the fields dirty and retry later */
+		schedule_cfg_flush();
+		return 0;
+	}
+	copy_cfg(&sent, &cfg);
+	dirty = 0;
+
+	stats.flushes++;
+	stats.sent += count;
+	if(!count) {
+		stats.suppressed++;
+	} else {
+		undo_record(&cfg);
+	}
+	return count;
+}
+
+const struct cfgwr_stats *cfgwr_stats(void)
+{
+	return &stats;
+}
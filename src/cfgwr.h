@@ -0,0 +1,51 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CFGWR_H_
+#define CFGWR_H_
+
+/* write-behind layer between the UI and spacenavd. Edits modify the global
+ * cfg and mark the changed fields dirty; cfgwr_flush hands the I/O thread only
+ * the final value of each dirty field which differs from what was last sent.
+ */
+
+struct cfgwr_stats {
+	unsigned long edits;		/* cfgwr_touch calls */
+	unsigned long coalesced;	/* edits merged into an already pending field */
+	unsigned long flushes;		/* flushes with pending edits */
+	unsigned long sent;			/* requests actually sent to spacenavd */
+	unsigned long suppressed;	/* flushes which turned out to be no-ops */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* resets the baseline to the config known to be in effect in spacenavd */
+void cfgwr_sync(const struct config *cur);
+
+void cfgwr_touch(unsigned int fields);
+int cfgwr_pending(void);
+int cfgwr_flush(void);
+
+const struct cfgwr_stats *cfgwr_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CFGWR_H_ */
@@ -0,0 +1,150 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "chord.h"
+
+void bnset_clear(struct bnset *s)
+{
+	memset(s, 0, sizeof *s);
+}
+
+int bnset_put(struct bnset *s, int bn, int val)
+{
+	uint64_t prev, bit = (uint64_t)1 << (bn & 63);
+	uint64_t *w = s->bits + (bn >> 6);
+
+	prev = *w;
+	if(val) {
+		*w |= bit;
+	} else {
+		*w &= ~bit;
+	}
+	return *w != prev;
+}
+
+int bnset_test(const struct bnset *s, int bn)
+{
+	return (s->bits[bn >> 6] >> (bn & 63)) & 1;
+}
+
+int bnset_count(const struct bnset *s)
+{
+	int i, n = 0;
+	for(i=0; i<BNSET_WORDS; i++) {
+		n += __builtin_popcountll(s->bits[i]);
+	}
+	return n;
+}
+
+int bnset_empty(const struct bnset *s)
+{
+	int i;
+	for(i=0; i<BNSET_WORDS; i++) {
+		if(s->bits[i]) return 0;
+	}
+	return 1;
+}
+
+int bnset_equal(const struct bnset *a, const struct bnset *b)
+{
+	return memcmp(a->bits, b->bits, sizeof a->bits) == 0;
+}
+
+int bnset_next(const struct bnset *s, int bn)
+{
+	int i = bn >> 6;
+	uint64_t w;
+
+	if(bn < 0 || bn >= BNSET_WORDS * 64) {
+		return -1;
+	}
+	/* mask off the bits below bn in its word, then skip empty words */
+	w = s->bits[i] & (~(uint64_t)0 << (bn & 63));
+	while(!w) {
+		if(++i >= BNSET_WORDS) return -1;
+		w = s->bits[i];
+	}
+	return (i << 6) + __builtin_ctzll(w);
+}
+
+
+void chord_reset(struct chord_track *ct)
+{
+	memset(ct, 0, sizeof *ct);
+	ct->last = -1;
+}
+
+static int find_chord(struct chord_track *ct, const struct bnset *set)
+{
+	int i, oldest = 0;
+
+	for(i=0; i<ct->nchords; i++) {
+		if(bnset_equal(&ct->chords[i].set, set)) {
+			return i;
+		}
+		if(ct->chords[i].last_usec < ct->chords[oldest].last_usec) {
+			oldest = i;
+		}
+	}
+
+	if(ct->nchords < CHORD_MAX) {
+		i = ct->nchords++;
+	} else {
+		i = oldest;
+	}
+	memset(ct->chords + i, 0, sizeof ct->chords[i]);
+	ct->chords[i].set = *set;
+	return i;
+}
+
+static void end_chord(struct chord_track *ct, long long usec)
+{
+	struct chord *c;
+	int bn;
+
+	if(bnset_count(&ct->cur) > 1) {
+		ct->last = find_chord(ct, &ct->cur);
+		c = ct->chords + ct->last;
+		c->count++;
+		c->last_usec = usec;
+		for(bn = bnset_next(&ct->cur, 0); bn != -1; bn = bnset_next(&ct->cur, bn + 1)) {
+			c->hold_msec[bn] = ct->hold_msec[bn];
+		}
+	}
+	bnset_clear(&ct->cur);
+}
+
+int chord_button(struct chord_track *ct, int bn, int press, long long usec)
+{
+	ct->last = -1;
+
+	if(bn < 0 || bn >= MAX_BUTTONS || !bnset_put(&ct->down, bn, press)) {
+		return 0;
+	}
+
+	if(press) {
+		ct->press_usec[bn] = usec;
+		bnset_put(&ct->cur, bn, 1);
+	} else {
+		ct->hold_msec[bn] = (usec - ct->press_usec[bn]) / 1000;
+		if(bnset_empty(&ct->down)) {
+			end_chord(ct, usec);
+		}
+	}
+	return 1;
+}
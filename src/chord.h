@@ -0,0 +1,78 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CHORD_H_
+#define CHORD_H_
+
+#include <stdint.h>
+#include "spnavcfg.h"
+
+/* set of device buttons, one bit per button */
+#define BNSET_WORDS		((MAX_BUTTONS + 63) / 64)
+
+struct bnset {
+	uint64_t bits[BNSET_WORDS];
+};
+
+/* distinct chords remembered, the least recently used one is replaced */
+#define CHORD_MAX		64
+
+struct chord {
+	struct bnset set;
+	unsigned long count;
+	long long last_usec;
+	/* how long each button was held the last time, indexed by button */
+	unsigned int hold_msec[MAX_BUTTONS];
+};
+
+/* a chord is everything pressed between the first press and the release of
+ * the last button still down, if that's more than a single button
+ */
+struct chord_track {
+	struct bnset down;
+	struct bnset cur;
+	long long press_usec[MAX_BUTTONS];
+	unsigned int hold_msec[MAX_BUTTONS];
+
+	struct chord chords[CHORD_MAX];
+	int nchords;
+	int last;		/* chord completed by the last event, or -1 */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bnset_clear(struct bnset *s);
+/* returns non-zero if the set changed */
+int bnset_put(struct bnset *s, int bn, int val);
+int bnset_test(const struct bnset *s, int bn);
+int bnset_count(const struct bnset *s);
+int bnset_empty(const struct bnset *s);
+int bnset_equal(const struct bnset *a, const struct bnset *b);
+/* first button in the set at or after bn, or -1 */
+int bnset_next(const struct bnset *s, int bn);
+
+void chord_reset(struct chord_track *ct);
+/* returns non-zero if the set of pressed buttons changed */
+int chord_button(struct chord_track *ct, int bn, int press, long long usec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CHORD_H_ */
@@ -0,0 +1,222 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <spnav.h>
+#include "cli.h"
+#include "spnavcfg.h"
+#include "cfgtext.h"
+#include "evrec.h"
+#include "profile.h"
+
+static const char *usage_fmt =
+	"Usage: %s [options]\n"
+	"Without any of the following options, starts the graphical configurator.\n"
+	"  --dump             print the current configuration\n"
+	"  --get <key>        print the value of a single setting\n"
+	"  --set <key=value>  change a setting (can be repeated)\n"
+	"  --apply <file>     apply all settings from a file (- for stdin)\n"
+	"  --save             save the configuration to the spacenavd config file\n"
+	"  --profile <name>   switch to a saved profile\n"
+	"  --save-profile <name> save the current configuration as a profile\n"
+	"  --list-profiles    list the saved profiles\n"
+	"  --export-csv <rec> convert an event recording (see --record) to CSV\n"
+	"  --help             print this usage information and exit\n"
+	"The output of --dump can be used as input for --apply.\n";
+
+static int is_cli_opt(const char *arg)
+{
+	static const char *opts[] = {"--dump", "--get", "--set", "--apply", "--save", "--export-csv",
+		"--profile", "--save-profile", "--list-profiles", "--help", "-h", 0};
+	int i;
+
+	for(i=0; opts[i]; i++) {
+		if(strcmp(arg, opts[i]) == 0) return 1;
+	}
+	return 0;
+}
+
+int cli_requested(int argc, char **argv)
+{
+	int i;
+
+	for(i=1; i<argc; i++) {
+		if(is_cli_opt(argv[i])) return 1;
+	}
+	return 0;
+}
+
+static int apply_file(const char *fname, struct config *newcfg)
+{
+	FILE *fp;
+	int res;
+
+	if(strcmp(fname, "-") == 0) {
+		fp = stdin;
+	} else if(!(fp = fopen(fname, "r"))) {
+		perror(fname);
+		return -1;
+	}
+	res = cfg_read(fp, newcfg, &devinfo);
+	if(fp != stdin) {
+		fclose(fp);
+	}
+	if(res == -1) {
+		fprintf(stderr, "%s: failed to apply configuration\n", fname);
+	}
+	return res;
+}
+
+int cli_main(int argc, char **argv)
+{
+	int i, j, res, count;
+	int dump = 0, save = 0, need_daemon = 0;
+	unsigned int mask = 0;
+	struct config newcfg = {0};
+	char *val, buf[512], **names;
+
+	for(i=1; i<argc; i++) {
+		if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+			printf(usage_fmt, argv[0]);
+			return 0;
+		}
+		if(!is_cli_opt(argv[i])) {
+			fprintf(stderr, "invalid option: %s\n", argv[i]);
+			fprintf(stderr, usage_fmt, argv[0]);
+			return 1;
+		}
+		if((strcmp(argv[i], "--get") == 0 || strcmp(argv[i], "--set") == 0 ||
+					strcmp(argv[i], "--apply") == 0 || strcmp(argv[i], "--export-csv") == 0 ||
+					strcmp(argv[i], "--profile") == 0 || strcmp(argv[i], "--save-profile") == 0)
+				&& !argv[i + 1]) {
+			fprintf(stderr, "%s must be followed by an argument\n", argv[i]);
+			return 1;
+		}
+
+		if(strcmp(argv[i], "--export-csv") == 0) {
+			if(evrec_export_csv(argv[++i], stdout) == -1) {
+				return 1;
+			}
+		} else if(strcmp(argv[i], "--list-profiles") == 0) {
+			names = profile_list(&count);
+			for(j=0; j<count; j++) {
+				printf("%s\n", names[j]);
+			}
+			profile_free_list(names, count);
+		} else {
+			need_daemon = 1;
+			if(strcmp(argv[i], "--dump") != 0 && strcmp(argv[i], "--save") != 0) {
+				i++;	/* skip the argument */
+			}
+		}
+	}
+	if(!need_daemon) {
+		return 0;
+	}
+
+	if(spnav_open() == -1) {
+		fprintf(stderr, "Failed to connect to spacenavd!\n");
+		return 1;
+	}
+	if(spnav_protocol() < 1) {
+		fprintf(stderr, "Currently running version of spacenavd is too old for this version of the configuration tool.\n");
+		spnav_close();
+		return 1;
+	}
+	spnav_client_name("spnavcfg");
+	spnav_evmask(0);
+
+	if(read_devinfo(&devinfo) == -1 || read_cfg(&cfg, &devinfo) == -1) {
+		fprintf(stderr, "Failed to read the current configuration.\n");
+		spnav_close();
+		return 1;
+	}
+	copy_cfg(&newcfg, &cfg);
+
+	/* process options in order, so that --get reflects preceding --set */
+	for(i=1; i<argc; i++) {
+		if(strcmp(argv[i], "--dump") == 0) {
+			dump = 1;
+
+		} else if(strcmp(argv[i], "--save") == 0) {
+			save = 1;
+
+		} else if(strcmp(argv[i], "--get") == 0) {
+			if(cfg_get_key(&newcfg, &devinfo, argv[++i], buf, sizeof buf) == -1) {
+				fprintf(stderr, "invalid key: %s\n", argv[i]);
+				goto err;
+			}
+			printf("%s\n", buf);
+
+		} else if(strcmp(argv[i], "--set") == 0) {
+			if(!(val = strchr(argv[++i], '='))) {
+				fprintf(stderr, "--set expects key=value, got: %s\n", argv[i]);
+				goto err;
+			}
+			*val++ = 0;
+			if((res = cfg_set_key(&newcfg, &devinfo, argv[i], val)) == -1) {
+				fprintf(stderr, "invalid setting: %s=%s\n", argv[i], val);
+				goto err;
+			}
+			mask |= res;
+
+		} else if(strcmp(argv[i], "--apply") == 0) {
+			if((res = apply_file(argv[++i], &newcfg)) == -1) {
+				goto err;
+			}
+			mask |= res;
+
+		} else if(strcmp(argv[i], "--profile") == 0) {
+			if((res = profile_load(argv[++i], &newcfg, &devinfo)) == -1) {
+				goto err;
+			}
+			mask |= res;
+
+		} else if(strcmp(argv[i], "--save-profile") == 0) {
+			if(profile_save(argv[++i], &newcfg, &devinfo) == -1) {
+				goto err;
+			}
+
+		} else if(strcmp(argv[i], "--export-csv") == 0) {
+			i++;	/* already handled */
+		}
+	}
+
+	if(mask) {
+		send_cfg_diff(&cfg, &newcfg, mask, &devinfo);
+		copy_cfg(&cfg, &newcfg);
+	}
+	if(save) {
+		spnav_cfg_save();
+	}
+
+	if(dump) {
+		printf("# device: %s\n", devinfo.name ? devinfo.name : "unknown");
+		printf("# path: %s\n", devinfo.path ? devinfo.path : "");
+		printf("# axes: %d, buttons: %d\n", devinfo.naxes, devinfo.nbuttons);
+		cfg_write(stdout, &cfg, &devinfo);
+	}
+
+	spnav_close();
+	return 0;
+
+err:
+	spnav_close();
+	return 1;
+}
@@ -0,0 +1,35 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CLI_H_
+#define CLI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns non-zero if the arguments request a command-line operation, which
+ * is carried out by cli_main without initializing any of the GUI.
+ */
+int cli_requested(int argc, char **argv);
+int cli_main(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* CLI_H_ */
@@ -0,0 +1,244 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <spnav.h>
+#include "evrec.h"
+#include "util.h"
+
+#define RECBUF_SIZE	256
+
+static int recfd = -1;
+static long long rec_start;
+static struct evrec recbuf[RECBUF_SIZE];
+static int recbuf_count;
+
+static int write_all(int fd, const void *buf, size_t sz)
+{
+	const char *ptr = buf;
+	ssize_t res;
+
+	while(sz > 0) {
+		if((res = write(fd, ptr, sz)) < 0) {
+			if(errno == EINTR) continue;
+			return -1;
+		}
+		ptr += res;
+		sz -= res;
+	}
+	return 0;
+}
+
+int evrec_start(const char *fname, const struct device_info *inf)
+{
+	struct evrec_header hdr;
+
+	if(recfd >= 0) {
+		evrec_stop();
+	}
+
+	if((recfd = open(fname, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644)) == -1) {
+		fprintf(stderr, "failed to open %s for recording: %s\n", fname, strerror(errno));
+		return -1;
+	}
+
+	rec_start = get_usec();
+
+	memset(&hdr, 0, sizeof hdr);
+	memcpy(hdr.magic, EVREC_MAGIC, sizeof hdr.magic);
+	hdr.hdrsize = sizeof hdr;
+	hdr.recsize = sizeof(struct evrec);
+	hdr.devtype = inf->type;
+	hdr.naxes = inf->naxes;
+	hdr.nbuttons = inf->nbuttons;
+	hdr.start_usec = rec_start;
+	if(inf->name) {
+		strncpy(hdr.devname, inf->name, EVREC_NAME_LEN - 1);
+	}
+
+	if(write_all(recfd, &hdr, sizeof hdr) == -1) {
+		fprintf(stderr, "failed to write recording header: %s\n", strerror(errno));
+		close(recfd);
+		recfd = -1;
+		return -1;
+	}
+	recbuf_count = 0;
+	return 0;
+}
+
+void evrec_stop(void)
+{
+	if(recfd < 0) return;
+
+	evrec_flush();
+	close(recfd);
+	recfd = -1;
+}
+
+int evrec_active(void)
+{
+	return recfd >= 0;
+}
+
+void evrec_event(const void *evptr)
+{
+	const spnav_event *ev = evptr;
+	struct evrec *rec;
+	int i;
+
+	if(recfd < 0) return;
+
+	rec = recbuf + recbuf_count;
+	memset(rec, 0, sizeof *rec);
+	rec->usec = get_usec() - rec_start;
+	rec->type = ev->type;
+
+	switch(ev->type) {
+	case SPNAV_EVENT_MOTION:
+		rec->period = ev->motion.period;
+		for(i=0; i<6; i++) {
+			rec->data[i] = ev->motion.data[i];
+		}
+		break;
+
+	case SPNAV_EVENT_BUTTON:
+	case SPNAV_EVENT_RAWBUTTON:
+		rec->data[0] = ev->button.bnum;
+		rec->data[1] = ev->button.press;
+		break;
+
+	case SPNAV_EVENT_RAWAXIS:
+		rec->data[0] = ev->axis.idx;
+		rec->data[1] = ev->axis.value;
+		break;
+
+	default:
+		break;
+	}
+
+	if(++recbuf_count >= RECBUF_SIZE) {
+		evrec_flush();
+	}
+}
+
+void evrec_flush(void)
+{
+	if(recfd < 0 || !recbuf_count) return;
+
+	if(write_all(recfd, recbuf, recbuf_count * sizeof *recbuf) == -1) {
+		fprintf(stderr, "failed to write recording, stopping: %s\n", strerror(errno));
+		close(recfd);
+		recfd = -1;
+	}
+	recbuf_count = 0;
+}
+
+
+int evrec_map(const char *fname, struct evrec_map *map)
+{
+	int fd;
+	struct stat st;
+
+	memset(map, 0, sizeof *map);
+
+	if((fd = open(fname, O_RDONLY)) == -1) {
+		fprintf(stderr, "failed to open recording %s: %s\n", fname, strerror(errno));
+		return -1;
+	}
+	fstat(fd, &st);
+	if(st.st_size < (off_t)sizeof(struct evrec_header)) {
+		fprintf(stderr, "%s: not an event recording\n", fname);
+		close(fd);
+		return -1;
+	}
+
+	map->size = st.st_size;
+	map->data = mmap(0, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map->data == MAP_FAILED) {
+		fprintf(stderr, "failed to map recording %s: %s\n", fname, strerror(errno));
+		map->data = 0;
+		return -1;
+	}
+
+	map->hdr = map->data;
+	if(memcmp(map->hdr->magic, EVREC_MAGIC, sizeof map->hdr->magic) != 0 ||
+			map->hdr->recsize != sizeof(struct evrec) ||
+			map->hdr->hdrsize < sizeof(struct evrec_header) || map->hdr->hdrsize > map->size) {
+		fprintf(stderr, "%s: not an event recording, or incompatible version\n", fname);
+		evrec_unmap(map);
+		return -1;
+	}
+
+	map->rec = (const struct evrec*)((const char*)map->data + map->hdr->hdrsize);
+	map->count = (map->size - map->hdr->hdrsize) / sizeof(struct evrec);
+	return 0;
+}
+
+void evrec_unmap(struct evrec_map *map)
+{
+	if(map->data) {
+		munmap(map->data, map->size);
+	}
+	memset(map, 0, sizeof *map);
+}
+
+int evrec_export_csv(const char *fname, FILE *out)
+{
+	long i;
+	const struct evrec *rec;
+	struct evrec_map map;
+
+	if(evrec_map(fname, &map) == -1) {
+		return -1;
+	}
+
+	fprintf(out, "usec,type,period,d0,d1,d2,d3,d4,d5\n");
+	for(i=0; i<map.count; i++) {
+		rec = map.rec + i;
+		fprintf(out, "%lld,", (long long)rec->usec);
+		switch(rec->type) {
+		case SPNAV_EVENT_MOTION:
+			fprintf(out, "motion,%u,%d,%d,%d,%d,%d,%d\n", (unsigned int)rec->period,
+					rec->data[0], rec->data[1], rec->data[2], rec->data[3],
+					rec->data[4], rec->data[5]);
+			break;
+		case SPNAV_EVENT_BUTTON:
+		case SPNAV_EVENT_RAWBUTTON:
+			fprintf(out, "%s,,%d,%d,,,,\n", rec->type == SPNAV_EVENT_BUTTON ? "button" : "rawbutton",
+					rec->data[0], rec->data[1]);
+			break;
+		case SPNAV_EVENT_RAWAXIS:
+			fprintf(out, "rawaxis,,%d,%d,,,,\n", rec->data[0], rec->data[1]);
+			break;
+		case SPNAV_EVENT_CFG:
+			fprintf(out, "cfg,,,,,,,\n");
+			break;
+		default:
+			fprintf(out, "%d,,,,,,,\n", (int)rec->type);
+		}
+	}
+
+	evrec_unmap(&map);
+	return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,78 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef EVREC_H_
+#define EVREC_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "spnavcfg.h"
+
+/* event recordings start with an evrec_header, followed by fixed-size evrec
+ * records, so a recording can be memory-mapped and indexed directly. All
+ * fields are in host byte order.
+ */
+#define EVREC_MAGIC		"SPNVREC1"
+#define EVREC_NAME_LEN	64
+
+struct evrec_header {
+	char magic[8];
+	uint32_t hdrsize, recsize;
+	int32_t devtype, naxes, nbuttons, pad;
+	int64_t start_usec;		/* monotonic clock at the start of the recording */
+	char devname[EVREC_NAME_LEN];
+};
+
+struct evrec {
+	int64_t usec;		/* time since the start of the recording */
+	int32_t type;		/* SPNAV_EVENT_* */
+	uint32_t period;	/* motion: msec since last motion event */
+	int32_t data[6];	/* motion: axes, button: number/press, rawaxis: index/value */
+};
+
+struct evrec_map {
+	void *data;
+	size_t size;
+	const struct evrec_header *hdr;
+	const struct evrec *rec;
+	long count;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the recorder appends to the file through a fixed buffer, and never allocates
+ * memory after evrec_start
+ */
+int evrec_start(const char *fname, const struct device_info *inf);
+void evrec_stop(void);
+int evrec_active(void);
+/* ev is a spnav_event */
+void evrec_event(const void *ev);
+void evrec_flush(void);
+
+int evrec_map(const char *fname, struct evrec_map *map);
+void evrec_unmap(struct evrec_map *map);
+
+int evrec_export_csv(const char *fname, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* EVREC_H_ */
@@ -0,0 +1,137 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "keysym.h"
+
+struct keysym_entry {
+	const char *name;
+	long sym;
+};
+
+/* defines keysym_byname and keysym_byval */
+#include "keysym_tab.h"
+
+#define NUM_KEYSYMS	(int)(sizeof keysym_byname / sizeof *keysym_byname)
+
+static int strprefix(const char *str, const char *prefix)
+{
+	return strncmp(str, prefix, strlen(prefix));
+}
+
+long keysym_lookup(const char *name)
+{
+	int lo, hi, mid, res;
+	char *endp;
+	long val;
+
+	if(!name || !*name) return 0;
+
+	lo = 0;
+	hi = NUM_KEYSYMS - 1;
+	while(lo <= hi) {
+		mid = (lo + hi) / 2;
+		if((res = strcmp(name, keysym_byname[mid].name)) == 0) {
+			return keysym_byname[mid].sym;
+		}
+		if(res < 0) {
+			hi = mid - 1;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	if(name[0] == '0' && (name[1] == 'x' || name[1] == 'X') && name[2]) {
+		val = strtol(name + 2, &endp, 16);
+		if(!*endp && val > 0 && val <= 0x1fffffff) {
+			return val;
+		}
+	}
+	if(name[0] == 'U' && name[1]) {
+		val = strtol(name + 1, &endp, 16);
+		if(!*endp && val >= 0x20 && val <= 0x10ffff) {
+			return val < 0x100 ? val : val | 0x1000000;
+		}
+	}
+	return 0;
+}
+
+const char *keysym_name(long sym)
+{
+	int lo, hi, mid;
+
+	lo = 0;
+	hi = NUM_KEYSYMS - 1;
+	while(lo <= hi) {
+		mid = (lo + hi) / 2;
+		if(keysym_byval[mid].sym == sym) {
+			/* several names can map to the same keysym, use the first one */
+			while(mid > 0 && keysym_byval[mid - 1].sym == sym) mid--;
+			return keysym_byval[mid].name;
+		}
+		if(sym < keysym_byval[mid].sym) {
+			hi = mid - 1;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return 0;
+}
+
+int keysym_count(void)
+{
+	return NUM_KEYSYMS;
+}
+
+const char *keysym_name_at(int idx)
+{
+	if(idx < 0 || idx >= NUM_KEYSYMS) return 0;
+	return keysym_byname[idx].name;
+}
+
+int keysym_prefix_range(const char *prefix, int *first)
+{
+	int lo, hi, mid, start;
+
+	/* lower bound of the first name not less than the prefix */
+	lo = 0;
+	hi = NUM_KEYSYMS;
+	while(lo < hi) {
+		mid = (lo + hi) / 2;
+		if(strcmp(keysym_byname[mid].name, prefix) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	start = lo;
+
+	/* all names with this prefix are contiguous from there */
+	hi = NUM_KEYSYMS;
+	while(lo < hi) {
+		mid = (lo + hi) / 2;
+		if(strprefix(keysym_byname[mid].name, prefix) == 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if(first) *first = start;
+	return lo - start;
+}
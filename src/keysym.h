@@ -0,0 +1,50 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef KEYSYM_H_
+#define KEYSYM_H_
+
+/* built-in X keysym catalog, generated from X11/keysymdef.h at build time.
+ * Lookups in either direction are binary searches over sorted tables, and
+ * don't need libX11 or a connection to an X server.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns the keysym for a name, or 0 (NoSymbol) if it's not valid. Besides
+ * the names in the catalog, accepts 0x<hex> and U<hex> (unicode) forms, like
+ * XStringToKeysym.
+ */
+long keysym_lookup(const char *name);
+/* returns the name of a keysym, or a null pointer if it's not in the catalog */
+const char *keysym_name(long sym);
+
+/* catalog entries are indexed in name order */
+int keysym_count(void);
+const char *keysym_name_at(int idx);
+/* returns the number of names starting with prefix, and the index of the
+ * first one in *first
+ */
+int keysym_prefix_range(const char *prefix, int *first);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* KEYSYM_H_ */
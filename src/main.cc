@@ -15,32 +15,160 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <QApplication>
 #include <QSocketNotifier>
 #define SPNAV_CONFIG_H_
 #include <spnav.h>
 #include "spnavcfg.h"
+#include "cfgwr.h"
+#include "cfgcache.h"
+#include "cli.h"
+#include "evrec.h"
+#include "replay.h"
+#include "spnavio.h"
+#include "trace.h"
+#include "undo.h"
 #include "ui.h"
+#include "util.h"
 
 static bool init();
+static bool init_replay();
+static void parse_args(int argc, char **argv);
+static void start_trace(const char *fname);
+static void prof_add(const char *name, long long usec);
+static void prof_stage(const char *name);
+static void prof_print();
 
 MainWin *mainwin;
 static QSocketNotifier *sockev;
 
+static bool startup_profile;
+static bool show_hud;
+static bool watch_apps;
+static bool connected;
+static const char *record_fname;
+static const char *replay_fname;
+static float replay_speed = 1.0f;
+
+#define MAX_PROF_STAGES	16
+static struct {
+	const char *name;
+	long long usec;
+} prof[MAX_PROF_STAGES];
+static int num_prof;
+static long long prof_start, prof_last;
+
 int main(int argc, char **argv)
 {
+	prof_start = prof_last = get_usec();
+
+	const char *env = getenv("SPNAVCFG_TRACE");
+	if(env && *env) {
+		start_trace(env);
+	}
+
+	if(cli_requested(argc, argv)) {
+		return cli_main(argc, argv);
+	}
+	parse_args(argc, argv);
+
 	QCoreApplication::setApplicationName("spnavcfg");
 
 	QApplication app(argc, argv);
+	prof_stage("Qt init");
+
 	MainWin w;
 	w.show();
 	mainwin = &w;
+	prof_stage("UI setup");
 
-	if(!init()) {
+	bool ok = replay_fname ? init_replay() : init();
+	if(!ok || replay_fname) {
+		prof_print();
+	}
+	if(!ok) {
 		return 1;
 	}
+	if(show_hud) {
+		mainwin->show_hud(true);
+	}
+	if(watch_apps) {
+		mainwin->watch_apps(true);
+	}
+
+	int res = app.exec();
+	cfgwr_flush();
+	spnavio_stop();
+	if(connected) {
+		cache_save(&cfg, &devinfo);
+	}
+	replay_stop();
+	evrec_stop();
+	return res;
+}
+
+static void parse_args(int argc, char **argv)
+{
+	for(int i=1; i<argc; i++) {
+		if(strcmp(argv[i], "--startup-profile") == 0) {
+			startup_profile = true;
+		} else if(strcmp(argv[i], "--hud") == 0) {
+			show_hud = true;
+		} else if(strcmp(argv[i], "--watch-apps") == 0) {
+			watch_apps = true;
+		} else if(strcmp(argv[i], "--record") == 0 && argv[i + 1]) {
+			record_fname = argv[++i];
+		} else if(strcmp(argv[i], "--replay") == 0 && argv[i + 1]) {
+			replay_fname = argv[++i];
+		} else if(strcmp(argv[i], "--replay-speed") == 0 && argv[i + 1]) {
+			i++;
+			/* "max" or 0 plays back as fast as the GUI consumes the events */
+			replay_speed = strcmp(argv[i], "max") == 0 ? 0.0f : atof(argv[i]);
+		} else if(strcmp(argv[i], "--trace") == 0 && argv[i + 1]) {
+			start_trace(argv[++i]);
+		}
+	}
+}
+
+/* the trace is written out at exit */
+static void start_trace(const char *fname)
+{
+	if(trace_start(fname) == -1) {
+		fprintf(stderr, "failed to start tracing\n");
+		return;
+	}
+	trace_thread_name("main");
+}
+
+static void prof_add(const char *name, long long usec)
+{
+	if(num_prof < MAX_PROF_STAGES) {
+		prof[num_prof].name = name;
+		prof[num_prof++].usec = usec;
+	}
+}
 
-	return app.exec();
+/* records the time since the previous stage */
+static void prof_stage(const char *name)
+{
+	long long t = get_usec();
+	prof_add(name, t - prof_last);
+	prof_last = t;
+}
+
+static void prof_print()
+{
+	if(!startup_profile) return;
+
+	fprintf(stderr, "startup profile:\n");
+	for(int i=0; i<num_prof; i++) {
+		fprintf(stderr, "  %-16s %9.3f ms\n", prof[i].name, prof[i].usec / 1000.0);
+	}
+	fprintf(stderr, "  %-16s %9.3f ms (included in the above)\n", "atlas load", atlas_load_usec / 1000.0);
+	fprintf(stderr, "  %-16s %9.3f ms\n", "total", (prof_last - prof_start) / 1000.0);
 }
 
 static bool init()
@@ -48,30 +176,84 @@ static bool init()
 	if(!mainwin->init()) {
 		return false;
 	}
+	prof_stage("UI init");
 
-	if(spnav_open() == -1) {
-		errorbox("Failed to connect to spacenavd!");
-		return false;
+	/* connecting and reading the configuration is up to the I/O thread, the
+	 * window comes up right away, and startup_complete is called when the
+	 * first configuration snapshot arrives. Until then the window shows the
+	 * cached state of the last device, if there is one.
+	 */
+	if(mainwin->load_cache()) {
+		prof_stage("cache load");
+	} else {
+		mainwin->centralWidget()->setEnabled(false);
 	}
-	if(spnav_protocol() < 1) {
-		errorbox("Currently running version of spacenavd is too old for this version of the configuration tool.\n"
-				"\nEither update to a recent version of spacenavd (v0.9 or later), or downgrade to spnavcfg v0.3.1.");
+	int fd = spnavio_start();
+	if(fd == -1) {
+		errorbox("Failed to start the spacenavd I/O thread.");
 		return false;
 	}
-	spnav_client_name("spnavcfg");
-	spnav_evmask(SPNAV_EVMASK_ALL);
+	prof_stage("I/O start");
+
+	sockev = new QSocketNotifier(fd, QSocketNotifier::Read);
+	QObject::connect(sockev, &QSocketNotifier::activated, mainwin, &MainWin::spnav_input);
+
+	return true;
+}
+
+void startup_complete(const struct io_snapshot *snap)
+{
+	connected = true;
+
+	if(record_fname && evrec_start(record_fname, &devinfo) == -1) {
+		errorboxf("Failed to start recording events to: %s", record_fname);
+	}
 
-	if(read_devinfo(&devinfo) == -1) {
-		errorbox("Failed to read device info.");
+	prof_add("io: spnav_open", snap->open_usec);
+	prof_add("io: read_devinfo", snap->devinfo_usec);
+	prof_add("io: read_cfg", snap->fetch.last_usec);
+	prof_stage("first snapshot");
+	prof_print();
+}
+
+/* replay mode: no spacenavd connection, the device info comes from the
+ * recording header, and the recorded events are fed to the same input handler
+ * through a pipe.
+ */
+static bool init_replay()
+{
+	if(!mainwin->init()) {
 		return false;
 	}
-	if(read_cfg(&cfg) == -1) {
-		errorbox("Failed to read current configuration.");
+	prof_stage("UI init");
+
+	int fd = replay_start(replay_fname, replay_speed, &devinfo);
+	if(fd == -1) {
+		errorboxf("Failed to open event recording: %s", replay_fname);
 		return false;
 	}
+	prof_stage("replay_start");
 
-	sockev = new QSocketNotifier(spnav_fd(), QSocketNotifier::Read);
-	QObject::connect(sockev, &QSocketNotifier::activated, mainwin, &MainWin::spnav_input);
+	if(record_fname && evrec_start(record_fname, &devinfo) == -1) {
+		errorboxf("Failed to start recording events to: %s", record_fname);
+	}
+
+	default_cfg(&cfg);
+	cfgwr_sync(&cfg);
+	undo_reset(&cfg);
+	update_ui();
+	prof_stage("UI update");
+
+	mainwin->setWindowTitle(mainwin->windowTitle() + " [replay]");
+
+	sockev = new QSocketNotifier(fd, QSocketNotifier::Read);
+	QObject::connect(sockev, &QSocketNotifier::activated, mainwin, [] {
+		mainwin->spnav_input();
+		if(replay_done()) {
+			/* EOF stays readable, stop watching once the recording is over */
+			sockev->setEnabled(false);
+		}
+	});
 
 	return true;
 }
@@ -0,0 +1,126 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <QPainter>
+#include <QPaintEvent>
+#include "meter.h"
+#include "perfstat.h"
+
+#define MARGIN	2
+
+AxisMeter::AxisMeter(QWidget *par)
+	: QWidget(par)
+{
+	val = 0;
+	maxval = 256;
+
+	setAttribute(Qt::WA_OpaquePaintEvent);
+	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void AxisMeter::setRange(int maxval)
+{
+	if(maxval < 1) maxval = 1;
+	if(maxval == this->maxval) return;
+
+	this->maxval = maxval;
+	update();
+}
+
+void AxisMeter::setValue(int v)
+{
+	if(v > maxval) v = maxval;
+	if(v < -maxval) v = -maxval;
+	if(v == val) return;
+
+	/* both bars start at the center, so the span between the two endpoints is
+	 * exactly the part of the track which changed.
+	 */
+	QRect ra = bar_rect(val);
+	QRect rb = bar_rect(v);
+	int x0 = std::min(ra.left(), rb.left());
+	int x1 = std::max(ra.right(), rb.right());
+	val = v;
+
+	update(QRect(x0, ra.top(), x1 - x0 + 1, ra.height()));
+	update(text_rect());
+}
+
+QSize AxisMeter::sizeHint() const
+{
+	return QSize(160, fontMetrics().height() + MARGIN * 2);
+}
+
+QSize AxisMeter::minimumSizeHint() const
+{
+	return QSize(text_rect().width() + 40, fontMetrics().height() + MARGIN * 2);
+}
+
+QRect AxisMeter::text_rect() const
+{
+	int tw = fontMetrics().boundingRect("-00000").width() + MARGIN * 2;
+	return QRect(width() - tw, 0, tw, height());
+}
+
+QRect AxisMeter::bar_rect(int v) const
+{
+	QRect track = rect().adjusted(MARGIN, MARGIN, -MARGIN - text_rect().width(), -MARGIN);
+	int half = track.width() / 2;
+	int cx = track.left() + half;
+	int len = v * half / maxval;
+
+	if(len >= 0) {
+		return QRect(cx, track.top(), len + 1, track.height());
+	}
+	return QRect(cx + len, track.top(), -len + 1, track.height());
+}
+
+void AxisMeter::paintEvent(QPaintEvent *ev)
+{
+	QPainter p(this);
+	const QPalette &pal = palette();
+
+	perf_painted();
+	p.setClipRegion(ev->region());
+	p.fillRect(rect(), pal.window());
+
+	QRect trect = text_rect();
+	QRect track = rect().adjusted(0, 0, -trect.width(), 0);
+	p.fillRect(track.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN), pal.base());
+	if(isEnabled()) {
+		p.fillRect(bar_rect(val), pal.highlight());
+	}
+
+	int cx = bar_rect(0).left();
+	p.setPen(pal.color(QPalette::Mid));
+	p.drawLine(cx, MARGIN, cx, height() - MARGIN - 1);
+
+	if(ev->region().intersects(trect)) {
+		p.setPen(pal.color(QPalette::WindowText));
+		p.drawText(trect.adjusted(0, 0, -MARGIN, 0), Qt::AlignRight | Qt::AlignVCenter,
+				QString::number(val));
+	}
+}
+
+void AxisMeter::changeEvent(QEvent *ev)
+{
+	if(ev->type() == QEvent::EnabledChange || ev->type() == QEvent::PaletteChange) {
+		update();
+	}
+	QWidget::changeEvent(ev);
+}
@@ -0,0 +1,50 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef METER_H_
+#define METER_H_
+
+#include <QWidget>
+
+/* lightweight bidirectional axis meter, replacing QProgressBar for the live
+ * motion display. Changing the value only invalidates the part of the bar
+ * which actually changed, plus the numeric readout.
+ */
+class AxisMeter : public QWidget {
+private:
+	int val, maxval;
+
+	QRect bar_rect(int v) const;
+	QRect text_rect() const;
+
+protected:
+	void paintEvent(QPaintEvent *ev);
+	void changeEvent(QEvent *ev);
+
+public:
+	explicit AxisMeter(QWidget *par = 0);
+
+	void setRange(int maxval);
+	int range() const { return maxval; }
+	void setValue(int v);
+	int value() const { return val; }
+
+	QSize sizeHint() const;
+	QSize minimumSizeHint() const;
+};
+
+#endif	/* METER_H_ */
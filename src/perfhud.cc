@@ -0,0 +1,163 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <QPainter>
+#include <QTimer>
+#define SPNAV_CONFIG_H_
+#include <spnav.h>
+#include "perfhud.h"
+#include "spnavcfg.h"
+#include "cfgwr.h"
+#include "spnavio.h"
+
+#define MARGIN		4
+#define HIST_HEIGHT	60
+
+static const char *drain_labels[PERF_DRAIN_BUCKETS] = {
+	"0", "1", "2-3", "4-7", "8-15", "16-31", "32-63", "64+"
+};
+
+static QString usec_label(int bucket)
+{
+	long long usec = 1LL << bucket;
+	if(usec >= 1000000) return QString("%1s").arg(usec / 1000000);
+	if(usec >= 1000) return QString("%1ms").arg(usec / 1000);
+	return QString("%1us").arg(usec);
+}
+
+PerfHud::PerfHud(QWidget *par)
+	: QWidget(par)
+{
+	memset(&prev, 0, sizeof prev);
+	memset(rate, 0, sizeof rate);
+	wakeup_rate = 0;
+
+	timer = new QTimer(this);
+	timer->setInterval(1000);
+	connect(timer, &QTimer::timeout, this, [this] { sample(); });
+
+	setToolTip("Double-click to reset the statistics");
+}
+
+QSize PerfHud::sizeHint() const
+{
+	return QSize(480, fontMetrics().height() * 6 + HIST_HEIGHT + MARGIN * 4);
+}
+
+void PerfHud::sample()
+{
+	for(int i=0; i<PERF_MAX_EVTYPE; i++) {
+		rate[i] = perfstat.events[i] - prev.events[i];
+	}
+	wakeup_rate = perfstat.wakeups - prev.wakeups;
+	prev = perfstat;
+	update();
+}
+
+void PerfHud::showEvent(QShowEvent *ev)
+{
+	prev = perfstat;
+	timer->start();
+	QWidget::showEvent(ev);
+}
+
+void PerfHud::hideEvent(QHideEvent *ev)
+{
+	timer->stop();
+	QWidget::hideEvent(ev);
+}
+
+void PerfHud::mouseDoubleClickEvent(QMouseEvent *ev)
+{
+	perf_reset();
+	memset(&prev, 0, sizeof prev);
+	memset(rate, 0, sizeof rate);
+	wakeup_rate = 0;
+	update();
+}
+
+void PerfHud::paintEvent(QPaintEvent *ev)
+{
+	QPainter p(this);
+	const QPalette &pal = palette();
+	int lineh = fontMetrics().height();
+	int y = MARGIN + fontMetrics().ascent();
+
+	p.fillRect(rect(), pal.base());
+	p.setPen(pal.color(QPalette::Text));
+
+	p.drawText(MARGIN, y, QString("events/s: motion %1  button %2  axis %3  config %4  wakeups %5"
+				"  (~%6 avoided by the event mask)")
+			.arg(rate[SPNAV_EVENT_MOTION]).arg(rate[SPNAV_EVENT_BUTTON] + rate[SPNAV_EVENT_RAWBUTTON])
+			.arg(rate[SPNAV_EVENT_RAWAXIS]).arg(rate[SPNAV_EVENT_CFG]).arg(wakeup_rate)
+			.arg(spnavio_avoided()));
+	y += lineh;
+
+	QString drain = "motion events per wakeup:";
+	if(spnavio_dropped()) {
+		drain = QString("%1 events dropped, ").arg(spnavio_dropped()) + drain;
+	}
+	for(int i=0; i<PERF_DRAIN_BUCKETS; i++) {
+		if(perfstat.drain_hist[i]) {
+			drain += QString("  [%1] %2").arg(drain_labels[i]).arg(perfstat.drain_hist[i]);
+		}
+	}
+	p.drawText(MARGIN, y, drain);
+	y += lineh;
+
+	const struct cfgwr_stats *wr = cfgwr_stats();
+	p.drawText(MARGIN, y, QString("config: %1 reads (last %2 ms, %3 coalesced)  %4 edits, %5 sent, %6 coalesced")
+			.arg(fetchstat.count).arg(fetchstat.last_usec / 1000.0, 0, 'f', 1).arg(fetchstat.coalesced)
+			.arg(wr->edits).arg(wr->sent).arg(wr->coalesced));
+	y += lineh;
+
+	unsigned long nlat = 0, maxcount = 1;
+	int first = PERF_LAT_BUCKETS, last = -1;
+	for(int i=0; i<PERF_LAT_BUCKETS; i++) {
+		unsigned long n = perfstat.lat_hist[i];
+		if(!n) continue;
+		nlat += n;
+		if(n > maxcount) maxcount = n;
+		if(i < first) first = i;
+		last = i;
+	}
+	p.drawText(MARGIN, y, QString("notify to paint latency: %1 samples, max %2 ms")
+			.arg(nlat).arg(perfstat.lat_max / 1000.0, 0, 'f', 2));
+	y += lineh / 2;
+
+	if(last < 0) return;
+
+	/* show at least a few buckets around the populated range */
+	if(first > 0) first--;
+	if(last - first < 7) last = first + 7 < PERF_LAT_BUCKETS ? first + 7 : PERF_LAT_BUCKETS - 1;
+
+	int nbars = last - first + 1;
+	int barw = (width() - MARGIN * 2) / nbars;
+	for(int i=0; i<nbars; i++) {
+		unsigned long n = perfstat.lat_hist[first + i];
+		int h = (int)(n * HIST_HEIGHT / maxcount);
+		int x = MARGIN + i * barw;
+
+		p.fillRect(x + 1, y + HIST_HEIGHT - h, barw - 2, h, pal.highlight());
+		p.drawText(QRect(x, y + HIST_HEIGHT, barw, lineh), Qt::AlignHCenter, usec_label(first + i));
+		if(n) {
+			p.drawText(QRect(x, y, barw, HIST_HEIGHT - h), Qt::AlignHCenter | Qt::AlignBottom,
+					QString::number(n));
+		}
+	}
+}
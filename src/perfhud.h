@@ -0,0 +1,50 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PERFHUD_H_
+#define PERFHUD_H_
+
+#include <QWidget>
+#include "perfstat.h"
+
+class QTimer;
+
+/* performance panel: per-type event rates, motion events drained per socket
+ * wakeup, and the histogram of latencies from the socket notification to the
+ * axis meter repaint. Only samples perfstat once per second while visible.
+ */
+class PerfHud : public QWidget {
+private:
+	QTimer *timer;
+	struct perf_stats prev;
+	unsigned long rate[PERF_MAX_EVTYPE], wakeup_rate;
+
+	void sample();
+
+protected:
+	void paintEvent(QPaintEvent *ev);
+	void showEvent(QShowEvent *ev);
+	void hideEvent(QHideEvent *ev);
+	void mouseDoubleClickEvent(QMouseEvent *ev);
+
+public:
+	explicit PerfHud(QWidget *par = 0);
+
+	QSize sizeHint() const;
+};
+
+#endif	/* PERFHUD_H_ */
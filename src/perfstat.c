@@ -0,0 +1,77 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "perfstat.h"
+#include "util.h"
+
+struct perf_stats perfstat;
+
+static long long frame_stamp;
+
+void perf_event(int type)
+{
+	if(type < 0 || type >= PERF_MAX_EVTYPE) type = 0;
+	perfstat.events[type]++;
+}
+
+void perf_wakeup(int nmotion)
+{
+	int b = nmotion > 0 ? perf_log2(nmotion) + 1 : 0;
+	if(b >= PERF_DRAIN_BUCKETS) b = PERF_DRAIN_BUCKETS - 1;
+
+	perfstat.wakeups++;
+	perfstat.drain_hist[b]++;
+}
+
+void perf_frame(long long wake_usec)
+{
+	frame_stamp = wake_usec;
+}
+
+void perf_painted(void)
+{
+	long long lat;
+	int b;
+
+	if(!frame_stamp) return;
+
+	lat = get_usec() - frame_stamp;
+	frame_stamp = 0;
+
+	b = perf_log2(lat > 0 ? lat : 1);
+	if(b >= PERF_LAT_BUCKETS) b = PERF_LAT_BUCKETS - 1;
+	perfstat.lat_hist[b]++;
+	if(lat > perfstat.lat_max) perfstat.lat_max = lat;
+}
+
+void perf_reset(void)
+{
+	memset(&perfstat, 0, sizeof perfstat);
+	frame_stamp = 0;
+}
+
+int perf_log2(unsigned long long x)
+{
+#ifdef __GNUC__
+	return x ? 63 - __builtin_clzll(x) : 0;
+#else
+	int res = 0;
+	while(x >>= 1) res++;
+	return res;
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PERFSTAT_H_
+#define PERFSTAT_H_
+
+/* event path instrumentation for the performance HUD. Histograms use fixed
+ * power of two buckets, so recording a sample is a couple of increments.
+ */
+
+#define PERF_MAX_EVTYPE		8	/* indexed by spnav_event type */
+
+/* latency bucket i counts samples in [2^i, 2^(i+1)) usec, the last one is
+ * open-ended (>= ~0.5 sec)
+ */
+#define PERF_LAT_BUCKETS	20
+/* drain bucket 0 counts wakeups without motion events, bucket i > 0 counts
+ * wakeups which drained [2^(i-1), 2^i) motion events
+ */
+#define PERF_DRAIN_BUCKETS	8
+
+struct perf_stats {
+	unsigned long events[PERF_MAX_EVTYPE];
+	unsigned long wakeups;
+	unsigned long drain_hist[PERF_DRAIN_BUCKETS];
+	unsigned long lat_hist[PERF_LAT_BUCKETS];
+	long long lat_max;
+};
+
+extern struct perf_stats perfstat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void perf_event(int type);
+/* called once per socket wakeup, after draining all pending events */
+void perf_wakeup(int nmotion);
+
+/* frame_update marks the wakeup time of the motion sample it's about to
+ * display, and the first meter to paint after that records the latency.
+ */
+void perf_frame(long long wake_usec);
+void perf_painted(void);
+
+void perf_reset(void);
+
+/* bucket index helper, exposed for the HUD labels */
+int perf_log2(unsigned long long x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* PERFSTAT_H_ */
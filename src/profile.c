@@ -0,0 +1,211 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "profile.h"
+#include "cfgtext.h"
+#include "cfgwr.h"
+
+#define PROFILE_SUFFIX	".conf"
+
+static int profile_dir(char *buf, int bufsz, int create)
+{
+	const char *base, *home;
+	int len;
+
+	if((base = getenv("XDG_CONFIG_HOME")) && *base) {
+		len = snprintf(buf, bufsz, "%s/spnavcfg", base);
+	} else if((home = getenv("HOME")) && *home) {
+		len = snprintf(buf, bufsz, "%s/.config/spnavcfg", home);
+	} else {
+		return -1;
+	}
+	if(len >= bufsz) return -1;
+
+	if(create && mkdir(buf, 0755) == -1 && errno != EEXIST) {
+		if(errno != ENOENT) return -1;
+		/* missing ~/.config */
+		*strrchr(buf, '/') = 0;
+		mkdir(buf, 0755);
+		buf[strlen(buf)] = '/';
+		if(mkdir(buf, 0755) == -1 && errno != EEXIST) return -1;
+	}
+
+	if(snprintf(buf + len, bufsz - len, "/profiles") >= bufsz - len) {
+		return -1;
+	}
+	if(create && mkdir(buf, 0755) == -1 && errno != EEXIST) {
+		fprintf(stderr, "failed to create profile directory %s: %s\n", buf, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+static int profile_path(const char *name, char *buf, int bufsz, int create)
+{
+	int len;
+
+	if(!profile_valid_name(name)) {
+		fprintf(stderr, "invalid profile name: %s\n", name);
+		return -1;
+	}
+	if(profile_dir(buf, bufsz, create) == -1) {
+		return -1;
+	}
+	len = strlen(buf);
+	if(snprintf(buf + len, bufsz - len, "/%s" PROFILE_SUFFIX, name) >= bufsz - len) {
+		return -1;
+	}
+	return 0;
+}
+
+int profile_valid_name(const char *name)
+{
+	return name && *name && *name != '.' && !strchr(name, '/');
+}
+
+static int cmp_names(const void *a, const void *b)
+{
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+char **profile_list(int *count)
+{
+	char path[1024];
+	DIR *dir;
+	struct dirent *dent;
+	char **names = 0, **tmp;
+	int num = 0, max = 0, len, slen = strlen(PROFILE_SUFFIX);
+
+	*count = 0;
+	if(profile_dir(path, sizeof path, 0) == -1 || !(dir = opendir(path))) {
+		return 0;
+	}
+
+	while((dent = readdir(dir))) {
+		len = strlen(dent->d_name);
+		if(len <= slen || dent->d_name[0] == '.' ||
+				strcmp(dent->d_name + len - slen, PROFILE_SUFFIX) != 0) {
+			continue;
+		}
+		if(num >= max) {
+			max = max ? max * 2 : 16;
+			if(!(tmp = realloc(names, max * sizeof *names))) break;
+			names = tmp;
+		}
+		if(!(names[num] = malloc(len - slen + 1))) break;
+		memcpy(names[num], dent->d_name, len - slen);
+		names[num++][len - slen] = 0;
+	}
+	closedir(dir);
+
+	if(num) {
+		qsort(names, num, sizeof *names, cmp_names);
+	}
+	*count = num;
+	return names;
+}
+
+void profile_free_list(char **names, int count)
+{
+	int i;
+	for(i=0; i<count; i++) {
+		free(names[i]);
+	}
+	free(names);
+}
+
+int profile_save(const char *name, const struct config *cfg, const struct device_info *inf)
+{
+	char path[1024];
+	FILE *fp;
+	int res;
+
+	if(profile_path(name, path, sizeof path, 1) == -1) {
+		return -1;
+	}
+	if(!(fp = fopen(path, "w"))) {
+		fprintf(stderr, "failed to write profile %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	fprintf(fp, "# spnavcfg profile: %s\n", name);
+	res = cfg_write(fp, cfg, inf);
+	if(fclose(fp) == -1) res = -1;
+	return res;
+}
+
+int profile_load(const char *name, struct config *cfg, const struct device_info *inf)
+{
+	char path[1024];
+	FILE *fp;
+	int res;
+
+	if(profile_path(name, path, sizeof path, 0) == -1) {
+		return -1;
+	}
+	if(!(fp = fopen(path, "r"))) {
+		fprintf(stderr, "failed to open profile %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	res = cfg_read(fp, cfg, inf);
+	fclose(fp);
+	return res;
+}
+
+int profile_remove(const char *name)
+{
+	char path[1024];
+
+	if(profile_path(name, path, sizeof path, 0) == -1) {
+		return -1;
+	}
+	if(remove(path) == -1) {
+		fprintf(stderr, "failed to remove profile %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+int profile_switch(const char *name)
+{
+	struct config newcfg = {0};
+	int fields, res;
+
+	copy_cfg(&newcfg, &cfg);
+	if((fields = profile_load(name, &newcfg, &devinfo)) == -1) {
+		free(newcfg.serdev);
+		return -1;
+	}
+	res = profile_apply(&newcfg, fields);
+	free(newcfg.serdev);
+	return res;
+}
+
+int profile_apply(const struct config *prof, unsigned int fields)
+{
+	/* anything still pending is superseded by the profile */
+	merge_cfg(&cfg, prof, fields);
+	if(fields) {
+		cfgwr_touch(fields);
+	}
+	return cfgwr_flush();
+}
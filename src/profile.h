@@ -0,0 +1,59 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include "spnavcfg.h"
+
+/* named configuration profiles, stored one per file in the cfgtext format
+ * under $XDG_CONFIG_HOME/spnavcfg/profiles/<name>.conf
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* names must be non-empty, and can't contain slashes or start with a dot */
+int profile_valid_name(const char *name);
+
+/* returns a sorted, malloc'd array of profile names, or null if there are
+ * none. Free with profile_free_list.
+ */
+char **profile_list(int *count);
+void profile_free_list(char **names, int count);
+
+int profile_save(const char *name, const struct config *cfg, const struct device_info *inf);
+/* reads the profile on top of cfg, returns the CFG_* flags of the fields it
+ * set, or -1 on error
+ */
+int profile_load(const char *name, struct config *cfg, const struct device_info *inf);
+int profile_remove(const char *name);
+
+/* switches the live configuration to the profile, through the write-behind
+ * layer, so only the fields which differ are sent to spacenavd. Returns the
+ * number of requests sent, or -1 on error.
+ */
+int profile_switch(const char *name);
+/* same, for a profile which was already loaded, with the fields it sets */
+int profile_apply(const struct config *prof, unsigned int fields);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* PROFILE_H_ */
@@ -0,0 +1,193 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "replay.h"
+#include "evrec.h"
+#include "util.h"
+
+static struct evrec_map map;
+static float speed;
+static int pfd[2] = {-1, -1};
+static pthread_t thread;
+static atomic_int quit;
+static int active, done;
+
+static void *replay_thread(void *arg);
+
+int replay_start(const char *fname, float spd, struct device_info *inf)
+{
+	if(active) {
+		replay_stop();
+	}
+
+	if(evrec_map(fname, &map) == -1) {
+		return -1;
+	}
+
+	free(inf->name);
+	free(inf->path);
+	memset(inf, 0, sizeof *inf);
+	inf->name = strdup(map.hdr->devname);
+	inf->path = strdup(fname);
+	inf->type = map.hdr->devtype;
+	inf->naxes = map.hdr->naxes > MAX_AXES ? MAX_AXES : map.hdr->naxes;
+	inf->nbuttons = map.hdr->nbuttons > MAX_BUTTONS ? MAX_BUTTONS : map.hdr->nbuttons;
+
+	if(pipe(pfd) == -1) {
+		fprintf(stderr, "replay: failed to create pipe: %s\n", strerror(errno));
+		evrec_unmap(&map);
+		return -1;
+	}
+	fcntl(pfd[0], F_SETFL, fcntl(pfd[0], F_GETFL) | O_NONBLOCK);
+
+	speed = spd;
+	atomic_store(&quit, 0);
+	done = 0;
+	if(pthread_create(&thread, 0, replay_thread, 0) != 0) {
+		fprintf(stderr, "replay: failed to start playback thread\n");
+		close(pfd[0]);
+		close(pfd[1]);
+		evrec_unmap(&map);
+		return -1;
+	}
+	active = 1;
+	return pfd[0];
+}
+
+void replay_stop(void)
+{
+	char buf[512];
+	ssize_t res;
+
+	if(!active) return;
+
+	atomic_store(&quit, 1);
+	/* the playback thread may be blocked on a full pipe. Reading until it
+	 * closes its end lets it see quit, and the read end is only closed after
+	 * that, so it can't get a SIGPIPE.
+	 */
+	fcntl(pfd[0], F_SETFL, fcntl(pfd[0], F_GETFL) & ~O_NONBLOCK);
+	while((res = read(pfd[0], buf, sizeof buf)) > 0 || (res == -1 && errno == EINTR));
+	pthread_join(thread, 0);
+	close(pfd[0]);
+	evrec_unmap(&map);
+	active = 0;
+}
+
+int replay_active(void)
+{
+	return active;
+}
+
+int replay_done(void)
+{
+	return done;
+}
+
+int replay_poll_event(spnav_event *ev)
+{
+	struct evrec rec;
+	ssize_t res;
+	int i;
+
+	if(!active || done) return 0;
+
+	/* records are written atomically (smaller than PIPE_BUF), so a read
+	 * either gets a whole record, nothing, or EOF
+	 */
+	while((res = read(pfd[0], &rec, sizeof rec)) == -1 && errno == EINTR);
+	if(res == 0) {
+		done = 1;
+		return 0;
+	}
+	if(res != sizeof rec) {
+		return 0;
+	}
+
+	memset(ev, 0, sizeof *ev);
+	ev->type = rec.type;
+	switch(rec.type) {
+	case SPNAV_EVENT_MOTION:
+		ev->motion.data = &ev->motion.x;
+		for(i=0; i<6; i++) {
+			ev->motion.data[i] = rec.data[i];
+		}
+		ev->motion.period = rec.period;
+		break;
+
+	case SPNAV_EVENT_BUTTON:
+	case SPNAV_EVENT_RAWBUTTON:
+		ev->button.bnum = rec.data[0];
+		ev->button.press = rec.data[1];
+		break;
+
+	case SPNAV_EVENT_RAWAXIS:
+		ev->axis.idx = rec.data[0];
+		ev->axis.value = rec.data[1];
+		break;
+
+	default:
+		break;
+	}
+	return rec.type;
+}
+
+static void *replay_thread(void *arg)
+{
+	long i;
+	long long start, target, now;
+	const struct evrec *rec;
+	sigset_t sigset;
+	ssize_t res;
+
+	/* nothing in the GUI ignores SIGPIPE. Should the read end ever go away
+	 * first, the write fails with EPIPE, and that ends the playback.
+	 */
+	sigemptyset(&sigset);
+	sigaddset(&sigset, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &sigset, 0);
+
+	start = get_usec();
+
+	for(i=0; i<map.count && !atomic_load(&quit); i++) {
+		rec = map.rec + i;
+
+		if(speed > 0.0f) {
+			target = start + (long long)(rec->usec / speed);
+			while(!atomic_load(&quit) && (now = get_usec()) < target) {
+				usleep(target - now > 100000 ? 100000 : target - now);
+			}
+		}
+
+		while((res = write(pfd[1], rec, sizeof *rec)) == -1 && errno == EINTR);
+		if(res != sizeof *rec) {
+			break;
+		}
+	}
+
+	close(pfd[1]);
+	return 0;
+}
@@ -0,0 +1,49 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <spnav.h>
+#include "spnavcfg.h"
+
+/* plays back an event recording (see evrec.h) through a pipe, standing in for
+ * the spacenavd socket. The recorded timing is scaled by speed (1 is real
+ * time, 2 is twice as fast, etc), or ignored altogether if speed <= 0.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* fills inf from the recording header, and returns a file descriptor to watch
+ * for readability, or -1 on failure.
+ */
+int replay_start(const char *fname, float speed, struct device_info *inf);
+void replay_stop(void);
+int replay_active(void);
+/* returns non-zero after the last event has been consumed */
+int replay_done(void);
+
+/* same semantics as spnav_poll_event */
+int replay_poll_event(spnav_event *ev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* REPLAY_H_ */
@@ -0,0 +1,67 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "ring.h"
+
+int ring_init(struct ring *r, unsigned int size, size_t elemsz)
+{
+	if(!size || (size & (size - 1))) {
+		return -1;
+	}
+	if(!(r->buf = malloc(size * elemsz))) {
+		return -1;
+	}
+	atomic_init(&r->head, 0);
+	atomic_init(&r->tail, 0);
+	r->mask = size - 1;
+	r->elemsz = elemsz;
+	return 0;
+}
+
+void ring_destroy(struct ring *r)
+{
+	free(r->buf);
+	r->buf = 0;
+}
+
+int ring_push(struct ring *r, const void *elem)
+{
+	unsigned int head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+	if(head - tail > r->mask) {
+		return -1;
+	}
+	memcpy(r->buf + (head & r->mask) * r->elemsz, elem, r->elemsz);
+	atomic_store_explicit(&r->head, head + 1, memory_order_release);
+	return 0;
+}
+
+int ring_pop(struct ring *r, void *elem)
+{
+	unsigned int tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&r->head, memory_order_acquire);
+
+	if(tail == head) {
+		return -1;
+	}
+	memcpy(elem, r->buf + (tail & r->mask) * r->elemsz, r->elemsz);
+	atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef RING_H_
+#define RING_H_
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+/* lock-free single producer, single consumer queue of fixed size elements.
+ * The producer only writes head, the consumer only writes tail, so each side
+ * needs nothing more than an acquire load of the other's index.
+ */
+struct ring {
+	atomic_uint head;
+	atomic_uint tail;
+	unsigned int mask;
+	size_t elemsz;
+	char *buf;
+};
+
+/* size must be a power of two */
+int ring_init(struct ring *r, unsigned int size, size_t elemsz);
+void ring_destroy(struct ring *r);
+
+/* return -1 if the ring is full/empty */
+int ring_push(struct ring *r, const void *elem);
+int ring_pop(struct ring *r, void *elem);
+
+#endif	/* RING_H_ */
@@ -0,0 +1,253 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <QPainter>
+#include <QTimer>
+#include "scope.h"
+#include "xform.h"
+#include "util.h"
+
+#define MARGIN	4
+
+static const char *axis_names[] = {"TX", "TY", "TZ", "RX", "RY", "RZ"};
+static const QColor axis_colors[] = {
+	QColor(220, 50, 47), QColor(64, 160, 43), QColor(38, 139, 210),
+	QColor(203, 75, 22), QColor(133, 153, 0), QColor(108, 113, 196)
+};
+
+ScopeView::ScopeView(QWidget *par)
+	: QWidget(par)
+{
+	head = count = 0;
+	maxval = 256;
+	window_usec = 5000000;
+	names = axis_names;
+
+	timer = new QTimer(this);
+	timer->setTimerType(Qt::PreciseTimer);
+	timer->setInterval(16);
+	connect(timer, &QTimer::timeout, this, [this] { frame(); });
+
+	setAttribute(Qt::WA_OpaquePaintEvent);
+	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+QSize ScopeView::sizeHint() const
+{
+	return QSize(480, 240);
+}
+
+QSize ScopeView::minimumSizeHint() const
+{
+	return QSize(160, 80);
+}
+
+void ScopeView::add(long long usec, const int *v)
+{
+	tm[head] = usec;
+	for(int i=0; i<6; i++) {
+		val[i][head] = v[i];
+	}
+	head = (head + 1) & (SCOPE_CAPACITY - 1);
+	if(count < SCOPE_CAPACITY) count++;
+
+	if(isVisible() && !timer->isActive()) {
+		timer->start();
+	}
+}
+
+int ScopeView::transform(const ScopeView *src, const struct xform *xf)
+{
+	const int *in[XFORM_AXES];
+	int *out[6];
+
+	/* the ring is never cleared, so the valid samples always start at 0 */
+	head = src->head;
+	count = src->count;
+	memcpy(tm, src->tm, count * sizeof *tm);
+
+	for(int i=0; i<XFORM_AXES; i++) {
+		in[i] = src->val[i];
+	}
+	for(int i=0; i<6; i++) {
+		out[i] = val[i];
+	}
+	xform_batch(xf, in, out, count);
+
+	int peak = 0;
+	for(int i=0; i<6; i++) {
+		for(int j=0; j<count; j++) {
+			int v = abs(val[i][j]);
+			if(v > peak) peak = v;
+		}
+	}
+
+	update();
+	if(isVisible() && count && !timer->isActive()) {
+		timer->start();
+	}
+	return peak;
+}
+
+void ScopeView::setLegend(const char *const *names)
+{
+	this->names = names;
+	update();
+}
+
+void ScopeView::setRange(int maxval)
+{
+	if(maxval < 1) maxval = 1;
+	this->maxval = maxval;
+}
+
+void ScopeView::setWindow(int sec)
+{
+	window_usec = (long long)sec * 1000000;
+	update();
+	if(isVisible() && count && !timer->isActive()) {
+		timer->start();
+	}
+}
+
+void ScopeView::setFrameInterval(int msec)
+{
+	timer->setInterval(msec > 0 ? msec : 1);
+}
+
+/* keep scrolling until the newest sample leaves the window, after that only
+ * the held last value would be drawn, which doesn't change
+ */
+void ScopeView::frame()
+{
+	int last = (head - 1) & (SCOPE_CAPACITY - 1);
+	if(!count || get_usec() - tm[last] > window_usec) {
+		timer->stop();
+	}
+	update();
+}
+
+void ScopeView::showEvent(QShowEvent *ev)
+{
+	if(count) timer->start();
+	QWidget::showEvent(ev);
+}
+
+void ScopeView::hideEvent(QHideEvent *ev)
+{
+	timer->stop();
+	QWidget::hideEvent(ev);
+}
+
+void ScopeView::paintEvent(QPaintEvent *ev)
+{
+	QPainter p(this);
+	const QPalette &pal = palette();
+	QRect r = rect().adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN);
+	int half = r.height() / 2;
+	int cy = r.top() + half;
+	long long now = get_usec();
+	long long t0 = now - window_usec;
+
+	p.fillRect(rect(), pal.base());
+
+	/* a grid line every second, or every 10 seconds for long windows */
+	long long step = window_usec > 10000000 ? 10000000 : 1000000;
+	p.setPen(pal.color(QPalette::Midlight));
+	for(long long t = now - step; t > t0; t -= step) {
+		int x = r.left() + (int)((t - t0) * r.width() / window_usec);
+		p.drawLine(x, r.top(), x, r.bottom());
+	}
+	p.setPen(pal.color(QPalette::Mid));
+	p.drawLine(r.left(), cy, r.right(), cy);
+
+	if(count) {
+		/* oldest sample to draw: the last one before the window starts, so
+		 * that the plot begins at the left edge
+		 */
+		int nsamples = 0;
+		int idx = head;
+		while(nsamples < count) {
+			idx = (idx - 1) & (SCOPE_CAPACITY - 1);
+			nsamples++;
+			if(tm[idx] < t0) break;
+		}
+
+		for(int i=0; i<6; i++) {
+			pts[i].clear();
+		}
+
+		int col = -1;
+		int mn[6], mx[6], cur[6];
+		for(int n=0; n<nsamples; n++, idx = (idx + 1) & (SCOPE_CAPACITY - 1)) {
+			long long t = tm[idx] < t0 ? t0 : tm[idx];
+			int x = r.left() + (int)((t - t0) * r.width() / window_usec);
+
+			if(x != col) {
+				if(col >= 0) {
+					for(int i=0; i<6; i++) {
+						pts[i].push_back(QPointF(col, cy - mn[i] * half / maxval));
+						if(mx[i] != mn[i]) {
+							pts[i].push_back(QPointF(col, cy - mx[i] * half / maxval));
+						}
+					}
+				}
+				col = x;
+				for(int i=0; i<6; i++) {
+					mn[i] = mx[i] = val[i][idx];
+				}
+			} else {
+				for(int i=0; i<6; i++) {
+					int v = val[i][idx];
+					if(v < mn[i]) mn[i] = v;
+					if(v > mx[i]) mx[i] = v;
+				}
+			}
+			for(int i=0; i<6; i++) {
+				cur[i] = val[i][idx];
+			}
+		}
+
+		/* flush the last column, and hold the latest value up to now */
+		for(int i=0; i<6; i++) {
+			pts[i].push_back(QPointF(col, cy - mn[i] * half / maxval));
+			if(mx[i] != mn[i]) {
+				pts[i].push_back(QPointF(col, cy - mx[i] * half / maxval));
+			}
+			pts[i].push_back(QPointF(col, cy - cur[i] * half / maxval));
+			pts[i].push_back(QPointF(r.right(), cy - cur[i] * half / maxval));
+		}
+
+		p.setClipRect(r);
+		for(int i=0; i<6; i++) {
+			p.setPen(axis_colors[i]);
+			p.drawPolyline(pts[i].data(), (int)pts[i].size());
+		}
+		p.setClipping(false);
+	}
+
+	/* legend */
+	int x = r.left() + MARGIN;
+	int y = r.top() + fontMetrics().ascent();
+	for(int i=0; i<6; i++) {
+		p.setPen(axis_colors[i]);
+		p.drawText(x, y, names[i]);
+		x += fontMetrics().boundingRect(names[i]).width() + MARGIN * 2;
+	}
+}
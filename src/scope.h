@@ -0,0 +1,74 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SCOPE_H_
+#define SCOPE_H_
+
+#include <vector>
+#include <QWidget>
+#include <QPointF>
+
+class QTimer;
+struct xform;
+
+/* ring buffer capacity in motion samples (must be a power of two), about a
+ * minute of history at 1kHz
+ */
+#define SCOPE_CAPACITY	65536
+
+/* scrolling plot of the six motion axes over the last 1-60 seconds. Samples
+ * are appended to a fixed ring buffer as they arrive, and every frame draws
+ * one polyline per axis, reduced to at most a min/max pair per pixel column.
+ */
+class ScopeView : public QWidget {
+private:
+	long long tm[SCOPE_CAPACITY];
+	int val[6][SCOPE_CAPACITY];
+	int head, count;
+
+	int maxval;
+	long long window_usec;
+	const char *const *names;
+	QTimer *timer;
+	std::vector<QPointF> pts[6];	/* reused across frames */
+
+	void frame();
+
+protected:
+	void paintEvent(QPaintEvent *ev);
+	void showEvent(QShowEvent *ev);
+	void hideEvent(QHideEvent *ev);
+
+public:
+	explicit ScopeView(QWidget *par = 0);
+
+	void add(long long usec, const int *v);
+	/* replaces the whole history with that of src run through the axis
+	 * transform, and returns the largest absolute value in the result
+	 */
+	int transform(const ScopeView *src, const struct xform *xf);
+
+	void setLegend(const char *const *names);
+	void setRange(int maxval);
+	void setWindow(int sec);
+	void setFrameInterval(int msec);
+
+	QSize sizeHint() const;
+	QSize minimumSizeHint() const;
+};
+
+#endif	/* SCOPE_H_ */
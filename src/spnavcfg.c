@@ -19,10 +19,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 #include <spnav.h>
 #include "spnavcfg.h"
-#include "ui.h"
+#include "trace.h"
 
 struct device_info devinfo;
 struct config cfg;
+struct fetch_stats fetchstat;
 
 int read_devinfo(struct device_info *inf)
 {
@@ -32,58 +33,234 @@ int read_devinfo(struct device_info *inf)
 	free(inf->path);
 	memset(inf, 0, sizeof *inf);
 
-	if((len = spnav_dev_name(0, 0)) > 0) {
+	TRACE_BEGIN("read_devinfo");
+
+	TRACE_CALL("spnav_dev_name", len = spnav_dev_name(0, 0));
+	if(len > 0) {
 		if((inf->name = malloc(len + 1))) {
-			spnav_dev_name(inf->name, len + 1);
+			TRACE_CALL("spnav_dev_name", spnav_dev_name(inf->name, len + 1));
 		}
 	}
-	if((len = spnav_dev_path(0, 0)) > 0) {
+	TRACE_CALL("spnav_dev_path", len = spnav_dev_path(0, 0));
+	if(len > 0) {
 		if((inf->path = malloc(len + 1))) {
-			spnav_dev_path(inf->path, len + 1);
+			TRACE_CALL("spnav_dev_path", spnav_dev_path(inf->path, len + 1));
 		}
 	}
-	if((inf->nbuttons = spnav_dev_buttons()) > MAX_BUTTONS) {
+	TRACE_CALL("spnav_dev_buttons", inf->nbuttons = spnav_dev_buttons());
+	if(inf->nbuttons > MAX_BUTTONS) {
 		inf->nbuttons = MAX_BUTTONS;
 	}
-	if((inf->naxes = spnav_dev_axes()) > MAX_AXES) {
+	TRACE_CALL("spnav_dev_axes", inf->naxes = spnav_dev_axes());
+	if(inf->naxes > MAX_AXES) {
 		inf->naxes = MAX_AXES;
 	}
-	inf->type = spnav_dev_type();
+	TRACE_CALL("spnav_dev_type", inf->type = spnav_dev_type());
+
+	TRACE_END();
+	if(inf->nbuttons < 0 || inf->naxes < 0) {
+		inf->nbuttons = inf->naxes = 0;
+		return -1;
+	}
 	return 0;
 }
 
-int read_cfg(struct config *cfg)
+/* libspnav returns -1 for a failed request, which is also a valid value of the
+ * axis, key and repeat settings. The rest can't be negative, and are checked
+ * to tell a lost connection from a configuration.
+ */
+int read_cfg(struct config *cfg, const struct device_info *inf)
 {
-	int i, len;
+	int i, len, res, nreq;
 
 	free(cfg->serdev);
 	memset(cfg, 0, sizeof *cfg);
 
-	cfg->sens = spnav_cfg_get_sens();
-	spnav_cfg_get_axis_sens(cfg->sens_axis);
-	cfg->invert = spnav_cfg_get_invert();
-	cfg->swapyz = spnav_cfg_get_swapyz();
-	cfg->led = spnav_cfg_get_led();
-	cfg->grab = spnav_cfg_get_grab();
+	TRACE_BEGIN("read_cfg");
 
-	for(i=0; i<devinfo.naxes; i++) {
-		cfg->map_axis[i] = spnav_cfg_get_axismap(i);
-		cfg->dead_thres[i] = spnav_cfg_get_deadzone(i);
+	TRACE_CALL("spnav_cfg_get_sens", cfg->sens = spnav_cfg_get_sens());
+	TRACE_CALL("spnav_cfg_get_axis_sens", res = spnav_cfg_get_axis_sens(cfg->sens_axis));
+	TRACE_CALL("spnav_cfg_get_invert", cfg->invert = spnav_cfg_get_invert());
+	TRACE_CALL("spnav_cfg_get_swapyz", cfg->swapyz = spnav_cfg_get_swapyz());
+	TRACE_CALL("spnav_cfg_get_led", cfg->led = spnav_cfg_get_led());
+	TRACE_CALL("spnav_cfg_get_grab", cfg->grab = spnav_cfg_get_grab());
+	nreq = 6;
+	if(cfg->sens < 0.0f || res == -1 || cfg->invert == -1 || cfg->swapyz == -1 ||
+			cfg->led == -1 || cfg->grab == -1) {
+		goto err;
 	}
-	for(i=0; i<devinfo.nbuttons; i++) {
-		cfg->map_bn[i] = spnav_cfg_get_bnmap(i);
-		cfg->bnact[i] = spnav_cfg_get_bnaction(i);
-		cfg->kbmap[i] = spnav_cfg_get_kbmap(i);
+
+	for(i=0; i<inf->naxes; i++) {
+		TRACE_CALL("spnav_cfg_get_axismap", cfg->map_axis[i] = spnav_cfg_get_axismap(i));
+		TRACE_CALL("spnav_cfg_get_deadzone", cfg->dead_thres[i] = spnav_cfg_get_deadzone(i));
+		if(cfg->dead_thres[i] == -1) goto err;
 	}
+	for(i=0; i<inf->nbuttons; i++) {
+		TRACE_CALL("spnav_cfg_get_bnmap", cfg->map_bn[i] = spnav_cfg_get_bnmap(i));
+		TRACE_CALL("spnav_cfg_get_bnaction", cfg->bnact[i] = spnav_cfg_get_bnaction(i));
+		TRACE_CALL("spnav_cfg_get_kbmap", cfg->kbmap[i] = spnav_cfg_get_kbmap(i));
+		if(cfg->map_bn[i] == -1 || cfg->bnact[i] == -1) goto err;
+	}
+	nreq += inf->naxes * 2 + inf->nbuttons * 3;
 
-	if((len = spnav_cfg_get_serial(0, 0)) > 0) {
+	TRACE_CALL("spnav_cfg_get_serial", len = spnav_cfg_get_serial(0, 0));
+	if(len == -1) goto err;
+	if(len > 0) {
 		if((cfg->serdev = malloc(len + 1))) {
-			spnav_cfg_get_serial(cfg->serdev, len + 1);
+			TRACE_CALL("spnav_cfg_get_serial", res = spnav_cfg_get_serial(cfg->serdev, len + 1));
+			nreq++;
+			if(res == -1) goto err;
 		}
 	}
 
-	cfg->repeat = spnav_cfg_get_repeat();
+	TRACE_CALL("spnav_cfg_get_repeat", cfg->repeat = spnav_cfg_get_repeat());
+	nreq += 2;
 
-	update_ui();
-	return 0;
+	TRACE_END();
+	return nreq;
+
+err:
+	TRACE_END();
+	return -1;
+}
+
+/* spacenavd built-in defaults, used when there is no daemon to ask */
+void default_cfg(struct config *cfg)
+{
+	int i;
+
+	free(cfg->serdev);
+	memset(cfg, 0, sizeof *cfg);
+
+	cfg->sens = 1.0f;
+	for(i=0; i<6; i++) {
+		cfg->sens_axis[i] = 1.0f;
+	}
+	for(i=0; i<MAX_AXES; i++) {
+		cfg->map_axis[i] = i < 6 ? i : -1;
+		cfg->dead_thres[i] = 2;
+	}
+	for(i=0; i<MAX_BUTTONS; i++) {
+		cfg->map_bn[i] = i;
+		cfg->kbmap[i] = -1;
+	}
+	cfg->led = 1;
+	cfg->grab = 1;
+	cfg->repeat = -1;
+}
+
+void copy_cfg(struct config *dst, const struct config *src)
+{
+	char *serdev = dst->serdev;
+
+	if(dst == src) return;
+
+	memcpy(dst, src, sizeof *dst);
+	free(serdev);
+	dst->serdev = src->serdev ? strdup(src->serdev) : 0;
+}
+
+void merge_cfg(struct config *dst, const struct config *src, unsigned int mask)
+{
+	if(mask & CFG_SENS) dst->sens = src->sens;
+	if(mask & CFG_SENS_AXIS) memcpy(dst->sens_axis, src->sens_axis, sizeof dst->sens_axis);
+	if(mask & CFG_INVERT) dst->invert = src->invert;
+	if(mask & CFG_SWAPYZ) dst->swapyz = src->swapyz;
+	if(mask & CFG_AXISMAP) memcpy(dst->map_axis, src->map_axis, sizeof dst->map_axis);
+	if(mask & CFG_DEADZONE) memcpy(dst->dead_thres, src->dead_thres, sizeof dst->dead_thres);
+	if(mask & CFG_BNMAP) memcpy(dst->map_bn, src->map_bn, sizeof dst->map_bn);
+	if(mask & CFG_BNACT) memcpy(dst->bnact, src->bnact, sizeof dst->bnact);
+	if(mask & CFG_KBMAP) memcpy(dst->kbmap, src->kbmap, sizeof dst->kbmap);
+	if(mask & CFG_LED) dst->led = src->led;
+	if(mask & CFG_GRAB) dst->grab = src->grab;
+	if(mask & CFG_REPEAT) dst->repeat = src->repeat;
+	if((mask & CFG_SERIAL) && dst->serdev != src->serdev) {
+		free(dst->serdev);
+		dst->serdev = src->serdev ? strdup(src->serdev) : 0;
+	}
+}
+
+static int streq(const char *a, const char *b)
+{
+	if(!a || !b) return a == b;
+	return strcmp(a, b) == 0;
+}
+
+/* with send == 0 only counts the requests which would be sent */
+static int diff_cfg(const struct config *from, const struct config *to, unsigned int mask,
+		const struct device_info *inf, int send)
+{
+	int i, count = 0;
+
+	if((mask & CFG_SENS) && from->sens != to->sens) {
+		if(send) TRACE_CALL("spnav_cfg_set_sens", spnav_cfg_set_sens(to->sens));
+		count++;
+	}
+	if((mask & CFG_SENS_AXIS) && memcmp(from->sens_axis, to->sens_axis, sizeof to->sens_axis) != 0) {
+		if(send) TRACE_CALL("spnav_cfg_set_axis_sens", spnav_cfg_set_axis_sens(to->sens_axis));
+		count++;
+	}
+	if((mask & CFG_INVERT) && from->invert != to->invert) {
+		if(send) TRACE_CALL("spnav_cfg_set_invert", spnav_cfg_set_invert(to->invert));
+		count++;
+	}
+	if((mask & CFG_SWAPYZ) && from->swapyz != to->swapyz) {
+		if(send) TRACE_CALL("spnav_cfg_set_swapyz", spnav_cfg_set_swapyz(to->swapyz));
+		count++;
+	}
+
+	for(i=0; i<inf->naxes; i++) {
+		if((mask & CFG_AXISMAP) && from->map_axis[i] != to->map_axis[i]) {
+			if(send) TRACE_CALL("spnav_cfg_set_axismap", spnav_cfg_set_axismap(i, to->map_axis[i]));
+			count++;
+		}
+		if((mask & CFG_DEADZONE) && from->dead_thres[i] != to->dead_thres[i]) {
+			if(send) TRACE_CALL("spnav_cfg_set_deadzone", spnav_cfg_set_deadzone(i, to->dead_thres[i]));
+			count++;
+		}
+	}
+	for(i=0; i<inf->nbuttons; i++) {
+		if((mask & CFG_BNMAP) && from->map_bn[i] != to->map_bn[i]) {
+			if(send) TRACE_CALL("spnav_cfg_set_bnmap", spnav_cfg_set_bnmap(i, to->map_bn[i]));
+			count++;
+		}
+		if((mask & CFG_BNACT) && from->bnact[i] != to->bnact[i]) {
+			if(send) TRACE_CALL("spnav_cfg_set_bnaction", spnav_cfg_set_bnaction(i, to->bnact[i]));
+			count++;
+		}
+		if((mask & CFG_KBMAP) && from->kbmap[i] != to->kbmap[i]) {
+			if(send) TRACE_CALL("spnav_cfg_set_kbmap", spnav_cfg_set_kbmap(i, to->kbmap[i]));
+			count++;
+		}
+	}
+
+	if((mask & CFG_LED) && from->led != to->led) {
+		if(send) TRACE_CALL("spnav_cfg_set_led", spnav_cfg_set_led(to->led));
+		count++;
+	}
+	if((mask & CFG_GRAB) && from->grab != to->grab) {
+		if(send) TRACE_CALL("spnav_cfg_set_grab", spnav_cfg_set_grab(to->grab));
+		count++;
+	}
+	if((mask & CFG_REPEAT) && from->repeat != to->repeat) {
+		if(send) TRACE_CALL("spnav_cfg_set_repeat", spnav_cfg_set_repeat(to->repeat));
+		count++;
+	}
+	if((mask & CFG_SERIAL) && !streq(from->serdev, to->serdev)) {
+		if(send) TRACE_CALL("spnav_cfg_set_serial", spnav_cfg_set_serial(to->serdev));
+		count++;
+	}
+	return count;
+}
+
+int send_cfg_diff(const struct config *from, const struct config *to, unsigned int mask,
+		const struct device_info *inf)
+{
+	return diff_cfg(from, to, mask, inf, 1);
+}
+
+int count_cfg_diff(const struct config *from, const struct config *to, unsigned int mask,
+		const struct device_info *inf)
+{
+	return diff_cfg(from, to, mask, inf, 0);
 }
@@ -43,15 +43,63 @@ struct config {
 	char *serdev;
 };
 
+/* config field flags, used to select which parts of a config to compare or
+ * send to spacenavd.
+ */
+enum {
+	CFG_SENS		= 0x0001,
+	CFG_SENS_AXIS	= 0x0002,
+	CFG_INVERT		= 0x0004,
+	CFG_SWAPYZ		= 0x0008,
+	CFG_AXISMAP		= 0x0010,
+	CFG_DEADZONE	= 0x0020,
+	CFG_BNMAP		= 0x0040,
+	CFG_BNACT		= 0x0080,
+	CFG_KBMAP		= 0x0100,
+	CFG_LED			= 0x0200,
+	CFG_GRAB		= 0x0400,
+	CFG_REPEAT		= 0x0800,
+	CFG_SERIAL		= 0x1000,
+
+	CFG_ALL			= 0x1fff
+};
+
+/* read_cfg timing: every read_cfg is a sequence of blocking round trips. In
+ * the GUI they're made by the I/O thread, and fetchstat is the copy which came
+ * with the last configuration snapshot.
+ */
+struct fetch_stats {
+	unsigned long count;		/* number of read_cfg calls */
+	unsigned long coalesced;	/* config events folded into a single read_cfg */
+	int last_nreq;				/* requests issued by the last read_cfg */
+	long long last_usec, total_usec;
+};
+
 extern struct device_info devinfo;
 extern struct config cfg;
+extern struct fetch_stats fetchstat;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* both return -1 if a request to spacenavd failed */
 int read_devinfo(struct device_info *inf);
-int read_cfg(struct config *cfg);
+/* returns the number of requests it took */
+int read_cfg(struct config *cfg, const struct device_info *inf);
+void default_cfg(struct config *cfg);
+
+void copy_cfg(struct config *dst, const struct config *src);
+/* copies only the fields selected by the mask */
+void merge_cfg(struct config *dst, const struct config *src, unsigned int mask);
+/* sends the fields selected by the mask which differ between from and to,
+ * returns the number of requests sent to spacenavd
+ */
+int send_cfg_diff(const struct config *from, const struct config *to, unsigned int mask,
+		const struct device_info *inf);
+/* same, without sending anything */
+int count_cfg_diff(const struct config *from, const struct config *to, unsigned int mask,
+		const struct device_info *inf);
 
 #ifdef __cplusplus
 }
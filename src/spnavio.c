@@ -0,0 +1,732 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include "spnavio.h"
+#include "ring.h"
+#include "util.h"
+#include "trace.h"
+
+#define EVQ_SIZE	1024
+#define CMDQ_SIZE	256
+
+/* reconnection backoff, doubling from min to max */
+#define RECONNECT_MIN_MSEC	100
+#define RECONNECT_MAX_MSEC	5000
+
+/* while the GUI leaves input events out of the mask, they're subscribed to for
+ * PROBE_MSEC every PROBE_INTERVAL_MSEC, and dropped. The wakeups they caused
+ * during the probe are extrapolated to the rest of the interval, as an
+ * estimate of the wakeups avoided.
+ */
+#define PROBE_INTERVAL_MSEC	10000
+#define PROBE_MSEC			250
+
+#define EVMASK_ALWAYS	(SPNAV_EVMASK_CFG | SPNAV_EVMASK_DEV)
+#define EVMASK_INPUT	(SPNAV_EVMASK_MOTION | SPNAV_EVMASK_BUTTON | \
+		SPNAV_EVMASK_RAWAXIS | SPNAV_EVMASK_RAWBUTTON)
+
+struct io_cmd {
+	int type;
+	unsigned long seq;
+	struct io_diff *diff;
+};
+
+struct io_diff {
+	struct config from, to;
+	unsigned int mask;
+};
+
+static pthread_t thread;
+static int running;
+
+static struct ring evq, cmdq;
+static _Atomic(struct io_snapshot*) mailbox;
+static atomic_int status;
+static atomic_ulong dropped;
+static atomic_uint want_mask = SPNAV_EVMASK_ALL;
+static atomic_ulong avoided;
+
+/* wakeup pipes, written only when the other side isn't already signaled */
+static int gui_pipe[2] = {-1, -1};
+static int io_pipe[2] = {-1, -1};
+static atomic_int gui_signaled, io_signaled;
+static atomic_int quit;
+
+/* GUI thread side */
+static unsigned long sent_seq;
+
+/* I/O thread side */
+static struct device_info iodev;
+static struct config iocfg;
+static struct fetch_stats iofetch;
+static unsigned long done_seq;
+static long long open_usec, devinfo_usec;
+static unsigned long reconnects;
+static long long reconnect_usec;
+static unsigned int evmask, wanted;		/* subscribed, and passed on to the GUI */
+static long long probe_start, next_probe;
+static unsigned long probe_wakeups;
+
+static void *io_thread(void *arg);
+
+static void signal_fd(int fd, atomic_int *flag)
+{
+	/* pairs with the fence in spnavio_ack/drain_io_pipe: either the other
+	 * side sees the new data, or we see the cleared flag and write
+	 */
+	atomic_thread_fence(memory_order_seq_cst);
+	if(!atomic_exchange(flag, 1)) {
+		while(write(fd, "x", 1) == -1 && errno == EINTR);
+	}
+}
+
+static void drain_fd(int fd, atomic_int *flag)
+{
+	char buf[64];
+
+	atomic_store(flag, 0);
+	atomic_thread_fence(memory_order_seq_cst);
+	while(read(fd, buf, sizeof buf) > 0);
+}
+
+int spnavio_start(void)
+{
+	int i;
+
+	if(running) return gui_pipe[0];
+
+	if(ring_init(&evq, EVQ_SIZE, sizeof(spnav_event)) == -1 ||
+			ring_init(&cmdq, CMDQ_SIZE, sizeof(struct io_cmd)) == -1) {
+		fprintf(stderr, "spnavio: failed to allocate queues\n");
+		goto err;
+	}
+	if(pipe(gui_pipe) == -1 || pipe(io_pipe) == -1) {
+		fprintf(stderr, "spnavio: failed to create pipe: %s\n", strerror(errno));
+		goto err;
+	}
+	for(i=0; i<2; i++) {
+		fcntl(gui_pipe[i], F_SETFL, fcntl(gui_pipe[i], F_GETFL) | O_NONBLOCK);
+		fcntl(io_pipe[i], F_SETFL, fcntl(io_pipe[i], F_GETFL) | O_NONBLOCK);
+	}
+
+	atomic_store(&status, IO_CONNECTING);
+	atomic_store(&quit, 0);
+	if(pthread_create(&thread, 0, io_thread, 0) != 0) {
+		fprintf(stderr, "spnavio: failed to start the I/O thread\n");
+		goto err;
+	}
+	running = 1;
+	return gui_pipe[0];
+
+err:
+	for(i=0; i<2; i++) {
+		if(gui_pipe[i] >= 0) close(gui_pipe[i]);
+		if(io_pipe[i] >= 0) close(io_pipe[i]);
+		gui_pipe[i] = io_pipe[i] = -1;
+	}
+	ring_destroy(&evq);
+	ring_destroy(&cmdq);
+	return -1;
+}
+
+void spnavio_stop(void)
+{
+	int i;
+	struct io_cmd cmd;
+
+	if(!running) return;
+
+	atomic_store(&quit, 1);
+	signal_fd(io_pipe[1], &io_signaled);
+	pthread_join(thread, 0);
+
+	while(ring_pop(&cmdq, &cmd) != -1) {
+		if(cmd.diff) {
+			free(cmd.diff->from.serdev);
+			free(cmd.diff->to.serdev);
+			free(cmd.diff);
+		}
+	}
+	spnavio_free_snapshot(atomic_exchange(&mailbox, 0));
+
+	for(i=0; i<2; i++) {
+		close(gui_pipe[i]);
+		close(io_pipe[i]);
+		gui_pipe[i] = io_pipe[i] = -1;
+	}
+	ring_destroy(&evq);
+	ring_destroy(&cmdq);
+	running = 0;
+}
+
+int spnavio_running(void)
+{
+	return running;
+}
+
+int spnavio_status(void)
+{
+	return atomic_load(&status);
+}
+
+void spnavio_ack(void)
+{
+	drain_fd(gui_pipe[0], &gui_signaled);
+}
+
+int spnavio_poll_event(spnav_event *ev)
+{
+	if(!running || ring_pop(&evq, ev) == -1) {
+		return 0;
+	}
+	if(ev->type == SPNAV_EVENT_MOTION) {
+		ev->motion.data = &ev->motion.x;	/* points into the original copy */
+	}
+	return ev->type;
+}
+
+unsigned long spnavio_dropped(void)
+{
+	return atomic_load(&dropped);
+}
+
+void spnavio_set_evmask(unsigned int mask)
+{
+	if(atomic_exchange(&want_mask, mask | EVMASK_ALWAYS) != (mask | EVMASK_ALWAYS) && running) {
+		signal_fd(io_pipe[1], &io_signaled);
+	}
+}
+
+unsigned long spnavio_avoided(void)
+{
+	return atomic_load(&avoided);
+}
+
+struct io_snapshot *spnavio_take_snapshot(void)
+{
+	return atomic_exchange(&mailbox, 0);
+}
+
+void spnavio_free_snapshot(struct io_snapshot *snap)
+{
+	if(!snap) return;
+	free(snap->cfg.serdev);
+	free(snap->dev.name);
+	free(snap->dev.path);
+	free(snap);
+}
+
+static int queue_cmd(int type, struct io_diff *diff)
+{
+	struct io_cmd cmd;
+
+	if(!running) return -1;
+
+	cmd.type = type;
+	cmd.seq = sent_seq + 1;
+	cmd.diff = diff;
+	if(ring_push(&cmdq, &cmd) == -1) {
+		return -1;
+	}
+	sent_seq++;
+	signal_fd(io_pipe[1], &io_signaled);
+	return 0;
+}
+
+int spnavio_send_diff(const struct config *from, const struct config *to, unsigned int mask)
+{
+	struct io_diff *diff;
+
+	if(!running) return -1;
+
+	if(!(diff = calloc(1, sizeof *diff))) {
+		return -1;
+	}
+	copy_cfg(&diff->from, from);
+	copy_cfg(&diff->to, to);
+	diff->mask = mask;
+
+	if(queue_cmd(IO_CMD_DIFF, diff) == -1) {
+		free(diff->from.serdev);
+		free(diff->to.serdev);
+		free(diff);
+		return -1;
+	}
+	return 0;
+}
+
+int spnavio_command(int cmd)
+{
+	return queue_cmd(cmd, 0);
+}
+
+unsigned long spnavio_sent_seq(void)
+{
+	return sent_seq;
+}
+
+
+/* ---- I/O thread ---- */
+
+static void set_status(int st)
+{
+	atomic_store(&status, st);
+	signal_fd(gui_pipe[1], &gui_signaled);
+}
+
+/* returns -1 if the connection was lost. iocfg is left alone in that case,
+ * to be restored after reconnecting.
+ */
+static int publish(void)
+{
+	struct io_snapshot *snap;
+	struct config cur = {0};
+	long long t0;
+	int nreq;
+
+	TRACE_BEGIN("publish");
+
+	t0 = get_usec();
+	if((nreq = read_cfg(&cur, &iodev)) == -1) {
+		free(cur.serdev);
+		TRACE_END();
+		return -1;
+	}
+	free(iocfg.serdev);
+	iocfg = cur;
+	iofetch.count++;
+	iofetch.last_nreq = nreq;
+	iofetch.last_usec = get_usec() - t0;
+	iofetch.total_usec += iofetch.last_usec;
+
+	if(!(snap = calloc(1, sizeof *snap))) {
+		TRACE_END();
+		return 0;
+	}
+	copy_cfg(&snap->cfg, &iocfg);
+	snap->dev = iodev;
+	snap->dev.name = iodev.name ? strdup(iodev.name) : 0;
+	snap->dev.path = iodev.path ? strdup(iodev.path) : 0;
+	snap->fetch = iofetch;
+	snap->cmd_seq = done_seq;
+	snap->open_usec = open_usec;
+	snap->devinfo_usec = devinfo_usec;
+	snap->reconnects = reconnects;
+	snap->reconnect_usec = reconnect_usec;
+
+	/* a snapshot the GUI didn't pick up yet is superseded */
+	spnavio_free_snapshot(atomic_exchange(&mailbox, snap));
+	signal_fd(gui_pipe[1], &gui_signaled);
+	TRACE_END();
+	return 0;
+}
+
+static int connect_daemon(void)
+{
+	long long t0 = get_usec();
+
+	if(spnav_open() == -1) {
+		return IO_FAILED;
+	}
+	if(spnav_protocol() < 1) {
+		spnav_close();
+		return IO_TOOOLD;
+	}
+	spnav_client_name("spnavcfg");
+	wanted = evmask = atomic_load(&want_mask);
+	spnav_evmask(evmask);
+	probe_start = 0;
+	next_probe = get_usec() + PROBE_INTERVAL_MSEC * 1000LL;
+	open_usec = get_usec() - t0;
+
+	t0 = get_usec();
+	if(read_devinfo(&iodev) == -1) {
+		spnav_close();
+		return IO_FAILED;
+	}
+	devinfo_usec = get_usec() - t0;
+	return IO_CONNECTED;
+}
+
+/* returns non-zero if any command was sent, and the configuration has to be
+ * re-read once the queue is drained: a snapshot published while the GUI had
+ * commands in flight is dropped as stale, whatever they were, and the next one
+ * can't wait for an unrelated event. While disconnected, edits are applied to
+ * the cached configuration, to be restored after reconnecting.
+ */
+static int process_commands(int online)
+{
+	struct io_cmd cmd;
+	int changed = 0;
+
+	while(ring_pop(&cmdq, &cmd) != -1) {
+		if(!online) {
+			if(cmd.type == IO_CMD_DIFF) {
+				merge_cfg(&iocfg, &cmd.diff->to, cmd.diff->mask);
+				free(cmd.diff->from.serdev);
+				free(cmd.diff->to.serdev);
+				free(cmd.diff);
+			}
+			done_seq = cmd.seq;
+			continue;
+		}
+
+		switch(cmd.type) {
+		case IO_CMD_DIFF:
+			TRACE_CALL("send_cfg_diff", send_cfg_diff(&cmd.diff->from, &cmd.diff->to,
+						cmd.diff->mask, &iodev));
+			free(cmd.diff->from.serdev);
+			free(cmd.diff->to.serdev);
+			free(cmd.diff);
+			break;
+
+		case IO_CMD_RESET:
+			TRACE_CALL("spnav_cfg_reset", spnav_cfg_reset());
+			break;
+
+		case IO_CMD_RESTORE:
+			TRACE_CALL("spnav_cfg_restore", spnav_cfg_restore());
+			break;
+
+		case IO_CMD_SAVE:
+			TRACE_CALL("spnav_cfg_save", spnav_cfg_save());
+			break;
+
+		default:
+			break;
+		}
+		done_seq = cmd.seq;
+		changed = 1;
+	}
+	return changed;
+}
+
+static unsigned int event_bit(int type)
+{
+	switch(type) {
+	case SPNAV_EVENT_MOTION:
+		return SPNAV_EVMASK_MOTION;
+	case SPNAV_EVENT_BUTTON:
+		return SPNAV_EVMASK_BUTTON;
+	case SPNAV_EVENT_DEV:
+		return SPNAV_EVMASK_DEV;
+	case SPNAV_EVENT_CFG:
+		return SPNAV_EVMASK_CFG;
+	case SPNAV_EVENT_RAWAXIS:
+		return SPNAV_EVMASK_RAWAXIS;
+	case SPNAV_EVENT_RAWBUTTON:
+		return SPNAV_EVMASK_RAWBUTTON;
+	default:
+		break;
+	}
+	return 0;
+}
+
+static void set_evmask(unsigned int mask)
+{
+	if(mask != evmask) {
+		spnav_evmask(mask);
+		evmask = mask;
+	}
+}
+
+/* follows the mask wanted by the GUI, and runs the probes while it leaves out
+ * any input events. Returns the usec until the next probe starts or ends, or
+ * -1 if there's nothing to wait for.
+ */
+static long long update_evmask(long long now)
+{
+	unsigned int missing;
+
+	wanted = atomic_load(&want_mask);
+	missing = EVMASK_INPUT & ~wanted;
+
+	if(probe_start) {
+		if(missing && now - probe_start < PROBE_MSEC * 1000LL) {
+			set_evmask(wanted | missing);
+			return probe_start + PROBE_MSEC * 1000LL - now;
+		}
+		/* a probe cut short by the GUI wanting everything again is discarded */
+		if(missing) {
+			atomic_fetch_add(&avoided, probe_wakeups * (PROBE_INTERVAL_MSEC - PROBE_MSEC) / PROBE_MSEC);
+		}
+		probe_start = 0;
+		next_probe = now + (PROBE_INTERVAL_MSEC - PROBE_MSEC) * 1000LL;
+	}
+
+	if(!missing) {
+		set_evmask(wanted);
+		return -1;
+	}
+	if(now >= next_probe) {
+		probe_start = now;
+		probe_wakeups = 0;
+		set_evmask(wanted | missing);
+		return PROBE_MSEC * 1000LL;
+	}
+	set_evmask(wanted);
+	return next_probe - now;
+}
+
+/* returns -1 if the connection was lost. readable is set when select woke us
+ * up for the socket, otherwise only the events libspnav already has are read.
+ */
+static int process_events(int *ncfgev, int *ndevev, int readable)
+{
+	spnav_event ev;
+	int nev = 0, nqueued = 0;
+	char c;
+
+	while(spnav_poll_event(&ev)) {
+		nev++;
+		if(!(event_bit(ev.type) & wanted)) {
+			/* probing, or still in flight from before the mask changed */
+			continue;
+		}
+		nqueued++;
+		if(ev.type == SPNAV_EVENT_CFG) {
+			TRACE_INSTANT("SPNAV_EVENT_CFG");
+			(*ncfgev)++;
+			continue;
+		}
+		if(ev.type == SPNAV_EVENT_DEV) {
+			(*ndevev)++;
+			continue;
+		}
+		if(ring_push(&evq, &ev) == -1) {
+			atomic_fetch_add(&dropped, 1);
+		}
+	}
+	if(nqueued) {
+		signal_fd(gui_pipe[1], &gui_signaled);
+	} else if(nev && readable && probe_start) {
+		probe_wakeups++;
+	}
+	if(nev || !readable) {
+		return 0;
+	}
+
+	/* readable without any events: check for EOF */
+	if(recv(spnav_fd(), &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+		return -1;
+	}
+	return 0;
+}
+
+/* handles the pending events, and re-reads what they or the commands before
+ * them changed. libspnav reads ahead while waiting for the reply to a request,
+ * and queues the events it finds on the way where select can't see them, so
+ * this goes on until a round of requests leaves none behind. Returns -1 if the
+ * connection was lost.
+ */
+static int handle_events(int readable, int changed)
+{
+	int ncfgev, ndevev;
+	struct device_info dev = {0};
+
+	for(;;) {
+		ncfgev = ndevev = 0;
+		if(process_events(&ncfgev, &ndevev, readable) == -1) {
+			return -1;
+		}
+		readable = 0;
+
+		if(ncfgev > 1) {
+			/* a burst of config events costs a single re-read */
+			iofetch.coalesced += ncfgev - 1;
+		}
+		if(ndevev) {
+			/* device hotplug. The old device info is kept until the new one
+			 * is complete, to tell whether to restore after reconnecting.
+			 */
+			if(read_devinfo(&dev) == -1) {
+				free(dev.name);
+				free(dev.path);
+				return -1;
+			}
+			free(iodev.name);
+			free(iodev.path);
+			iodev = dev;
+			dev.name = dev.path = 0;
+		}
+		if(!changed && !ncfgev && !ndevev) {
+			return 0;
+		}
+		if(publish() == -1) {
+			return -1;
+		}
+		changed = 0;
+	}
+}
+
+/* serves the connection until it's lost (returns -1) or we're asked to quit.
+ * Starts by publishing the configuration of the new connection.
+ */
+static int serve(void)
+{
+	int sfd, maxfd, readable = 0, changed = 1;
+	long long wait;
+	fd_set rdset;
+	struct timeval tv;
+
+	sfd = spnav_fd();
+	maxfd = sfd > io_pipe[0] ? sfd : io_pipe[0];
+
+	while(!atomic_load(&quit)) {
+		/* including those read ahead before we got here */
+		if(handle_events(readable, changed) == -1) {
+			return -1;
+		}
+		readable = changed = 0;
+
+		FD_ZERO(&rdset);
+		FD_SET(sfd, &rdset);
+		FD_SET(io_pipe[0], &rdset);
+
+		if((wait = update_evmask(get_usec())) >= 0) {
+			tv.tv_sec = wait / 1000000;
+			tv.tv_usec = wait % 1000000;
+		}
+		if(select(maxfd + 1, &rdset, 0, 0, wait >= 0 ? &tv : 0) == -1) {
+			if(errno == EINTR) continue;
+			return -1;
+		}
+		readable = FD_ISSET(sfd, &rdset);
+
+		if(FD_ISSET(io_pipe[0], &rdset)) {
+			drain_fd(io_pipe[0], &io_signaled);
+			/* commands queued before quitting are still sent */
+			changed = process_commands(1);
+			if(atomic_load(&quit)) break;
+			/* filter the events below with the new mask, if that's what woke us */
+			update_evmask(get_usec());
+		}
+	}
+	return 0;
+}
+
+/* sleeps for up to msec, handling commands offline. Returns -1 on quit. */
+static int wait_offline(long msec)
+{
+	fd_set rdset;
+	struct timeval tv;
+	long long end = get_usec() + msec * 1000LL;
+	long long left;
+
+	while((left = end - get_usec()) > 0) {
+		tv.tv_sec = left / 1000000;
+		tv.tv_usec = left % 1000000;
+
+		FD_ZERO(&rdset);
+		FD_SET(io_pipe[0], &rdset);
+		if(select(io_pipe[0] + 1, &rdset, 0, 0, &tv) > 0) {
+			drain_fd(io_pipe[0], &io_signaled);
+			process_commands(0);
+		}
+		if(atomic_load(&quit)) return -1;
+	}
+	return 0;
+}
+
+/* the restarted daemon starts from its config file. If it's still the same
+ * device, bring back the configuration we had before losing the connection.
+ */
+static void restore_cached(const struct device_info *prev)
+{
+	struct config cur = {0};
+
+	if(prev->naxes != iodev.naxes || prev->nbuttons != iodev.nbuttons || prev->type != iodev.type) {
+		return;
+	}
+	if(read_cfg(&cur, &iodev) != -1) {
+		send_cfg_diff(&cur, &iocfg, CFG_ALL, &iodev);
+	}
+	free(cur.serdev);
+}
+
+static int reconnect(void)
+{
+	struct device_info prev;
+	long msec = RECONNECT_MIN_MSEC;
+	long long t0 = get_usec();
+	int st;
+
+	spnav_close();
+	set_status(IO_DISCONNECTED);
+
+	prev = iodev;
+	prev.name = prev.path = 0;
+
+	for(;;) {
+		if(wait_offline(msec) == -1) {
+			return -1;
+		}
+		if((st = connect_daemon()) == IO_CONNECTED) {
+			break;
+		}
+		if(st == IO_TOOOLD) {
+			set_status(st);
+			return -1;
+		}
+		if((msec *= 2) > RECONNECT_MAX_MSEC) {
+			msec = RECONNECT_MAX_MSEC;
+		}
+	}
+
+	/* edits made while we were away are in iocfg by now */
+	process_commands(0);
+	restore_cached(&prev);
+
+	reconnects++;
+	reconnect_usec = get_usec() - t0;
+	set_status(IO_CONNECTED);
+	return 0;
+}
+
+static void *io_thread(void *arg)
+{
+	int st;
+
+	trace_thread_name("spacenavd I/O");
+
+	if((st = connect_daemon()) != IO_CONNECTED) {
+		set_status(st);
+		return 0;
+	}
+	set_status(IO_CONNECTED);
+
+	while(serve() == -1) {
+		if(reconnect() == -1) {
+			break;
+		}
+	}
+
+	spnav_close();
+	free(iocfg.serdev);
+	iocfg.serdev = 0;
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SPNAVIO_H_
+#define SPNAVIO_H_
+
+#include <spnav.h>
+#include "spnavcfg.h"
+
+/* the I/O thread owns the spacenavd connection. The GUI thread hands it
+ * commands through a lock-free queue, and gets back input events through
+ * another, and immutable configuration snapshots through a single-slot
+ * mailbox. A pipe wakes up the GUI whenever there's something new.
+ */
+
+enum {
+	IO_CONNECTING,
+	IO_CONNECTED,
+	IO_FAILED,			/* failed to connect to spacenavd */
+	IO_TOOOLD,			/* spacenavd protocol too old */
+	IO_DISCONNECTED		/* lost the connection, trying to reconnect */
+};
+
+enum {
+	IO_CMD_DIFF,		/* send the difference of two configurations */
+	IO_CMD_RESET,		/* restore the spacenavd defaults */
+	IO_CMD_RESTORE,		/* reload the spacenavd config file */
+	IO_CMD_SAVE			/* save the spacenavd config file */
+};
+
+/* configuration and device info as read by the I/O thread */
+struct io_snapshot {
+	struct config cfg;
+	struct device_info dev;
+	struct fetch_stats fetch;
+	/* the last command processed before reading cfg. A snapshot older than
+	 * the last command sent doesn't reflect all edits yet.
+	 */
+	unsigned long cmd_seq;
+	long long open_usec, devinfo_usec;	/* connection setup timing */
+	unsigned long reconnects;			/* number of reconnections so far */
+	long long reconnect_usec;			/* time from losing to restoring the last one */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns a file descriptor which becomes readable when there are events, a
+ * new snapshot, or a status change, or -1 on failure
+ */
+int spnavio_start(void);
+void spnavio_stop(void);
+int spnavio_running(void);
+int spnavio_status(void);
+
+/* call before draining events after a wakeup */
+void spnavio_ack(void);
+/* same semantics as spnav_poll_event */
+int spnavio_poll_event(spnav_event *ev);
+/* events dropped because the GUI fell too far behind */
+unsigned long spnavio_dropped(void);
+
+/* input events to subscribe to (SPNAV_EVMASK_* bits), configuration and
+ * device events are always included
+ */
+void spnavio_set_evmask(unsigned int mask);
+/* estimated socket wakeups avoided by the event mask so far */
+unsigned long spnavio_avoided(void);
+
+/* takes ownership of the latest snapshot, or returns null if there isn't a
+ * new one since the last call
+ */
+struct io_snapshot *spnavio_take_snapshot(void);
+void spnavio_free_snapshot(struct io_snapshot *snap);
+
+/* queue commands for the I/O thread, return -1 if the queue is full */
+int spnavio_send_diff(const struct config *from, const struct config *to, unsigned int mask);
+int spnavio_command(int cmd);
+/* sequence number of the last command queued */
+unsigned long spnavio_sent_seq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* SPNAVIO_H_ */
@@ -0,0 +1,214 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "trace.h"
+
+struct trace_event {
+	const char *name;
+	long long nsec;
+	char type;			/* Chrome event phase: B, E, or i */
+};
+
+struct trace_buf {
+	struct trace_buf *next;
+	int tid;
+	_Atomic(const char*) name;
+	atomic_uint count;	/* published with release, after the event is written */
+	atomic_ulong lost;
+	/* spans in progress, recorded or dropped. Only their own thread uses them */
+	unsigned int depth, dropped;
+	struct trace_event ev[TRACE_BUF_EVENTS];
+};
+
+static atomic_int trace_enabled;
+
+static char *trace_fname;
+static long long start_nsec;
+static _Atomic(struct trace_buf*) buffers;
+static atomic_int next_tid;
+static _Thread_local struct trace_buf *tbuf;
+
+static long long get_nsec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* a thread's buffer is created on its first trace point, and linked to the
+ * list of buffers with a compare-and-swap
+ */
+static struct trace_buf *thread_buf(void)
+{
+	struct trace_buf *buf;
+
+	if(tbuf) return tbuf;
+
+	if(!(buf = calloc(1, sizeof *buf))) {
+		return 0;
+	}
+	buf->tid = atomic_fetch_add(&next_tid, 1) + 1;
+	buf->next = atomic_load(&buffers);
+	while(!atomic_compare_exchange_weak(&buffers, &buf->next, buf));
+
+	tbuf = buf;
+	return buf;
+}
+
+/* the end of every recorded span has a slot kept for it. A span which doesn't
+ * fit along with its end is dropped whole, and so is everything nested in it,
+ * since nothing is recorded until it ends that would free any room.
+ */
+static void record(const char *name, char type)
+{
+	struct trace_buf *buf;
+	unsigned int n, need;
+
+	if(!(buf = thread_buf())) return;
+
+	n = atomic_load_explicit(&buf->count, memory_order_relaxed);
+	switch(type) {
+	case 'B':
+		need = 2;
+		break;
+	case 'E':
+		if(buf->dropped) {
+			buf->dropped--;
+			atomic_fetch_add_explicit(&buf->lost, 1, memory_order_relaxed);
+			return;
+		}
+		if(!buf->depth) return;		/* begun before tracing started */
+		buf->depth--;
+		need = 1;		/* the slot kept for it, always there */
+		break;
+	default:
+		need = 1;
+		break;
+	}
+	if(n + buf->depth + need > TRACE_BUF_EVENTS) {
+		if(type == 'B') buf->dropped++;
+		atomic_fetch_add_explicit(&buf->lost, 1, memory_order_relaxed);
+		return;
+	}
+	if(type == 'B') buf->depth++;
+
+	buf->ev[n].name = name;
+	buf->ev[n].nsec = get_nsec();
+	buf->ev[n].type = type;
+	atomic_store_explicit(&buf->count, n + 1, memory_order_release);
+}
+
+/* read relaxed: a trace point racing with trace_stop is dropped either way */
+int trace_is_enabled(void)
+{
+	return atomic_load_explicit(&trace_enabled, memory_order_relaxed);
+}
+
+int trace_start(const char *fname)
+{
+	if(atomic_load(&trace_enabled)) return 0;
+
+	if(!(trace_fname = strdup(fname))) {
+		return -1;
+	}
+	start_nsec = get_nsec();
+	atomic_store(&trace_enabled, 1);
+	atexit(trace_stop);
+	return 0;
+}
+
+void trace_stop(void)
+{
+	FILE *fp;
+	struct trace_buf *buf;
+	unsigned int i, n;
+	unsigned long lost;
+	long long t;
+	const char *sep = "", *name;
+
+	if(!atomic_exchange(&trace_enabled, 0)) return;
+
+	if(!(fp = fopen(trace_fname, "w"))) {
+		fprintf(stderr, "failed to write trace %s: %s\n", trace_fname, strerror(errno));
+		return;
+	}
+
+	/* threads still running might keep appending past n, so the buffers are
+	 * left alone after this
+	 */
+	fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	for(buf = atomic_load(&buffers); buf; buf = buf->next) {
+		if((name = atomic_load(&buf->name))) {
+			fprintf(fp, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, "
+					"\"args\": {\"name\": \"%s\"}}", sep, buf->tid, name);
+			sep = ",\n";
+		}
+		if((lost = atomic_load(&buf->lost))) {
+			fprintf(stderr, "trace: %lu events lost on thread %d, buffer full\n", lost, buf->tid);
+		}
+
+		n = atomic_load_explicit(&buf->count, memory_order_acquire);
+		for(i=0; i<n; i++) {
+			struct trace_event *ev = buf->ev + i;
+
+			t = ev->nsec - start_nsec;
+			fprintf(fp, "%s{\"ph\": \"%c\", \"ts\": %lld.%03lld, \"pid\": 1, \"tid\": %d", sep,
+					ev->type, t / 1000, t % 1000, buf->tid);
+			if(ev->name) {
+				fprintf(fp, ", \"name\": \"%s\"", ev->name);
+			}
+			if(ev->type == 'i') {
+				fprintf(fp, ", \"s\": \"t\"");
+			}
+			fputc('}', fp);
+			sep = ",\n";
+		}
+	}
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+}
+
+void trace_thread_name(const char *name)
+{
+	struct trace_buf *buf;
+
+	if(trace_is_enabled() && (buf = thread_buf())) {
+		atomic_store(&buf->name, name);
+	}
+}
+
+void trace_begin(const char *name)
+{
+	record(name, 'B');
+}
+
+void trace_end(void)
+{
+	record(0, 'E');
+}
+
+void trace_instant(const char *name)
+{
+	record(name, 'i');
+}
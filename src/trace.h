@@ -0,0 +1,78 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/* span tracer, written out in the Chrome trace event format (load it in
+ * chrome://tracing or ui.perfetto.dev). Every thread records into its own
+ * fixed-size buffer without locking; the buffers are only read when the trace
+ * is written out at exit. Disabled, a trace point costs a call and a test.
+ */
+
+/* events per thread, further events are counted and dropped. Room for the
+ * end of every span in progress is kept, so only whole spans are dropped.
+ */
+#define TRACE_BUF_EVENTS	262144
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* tracing is enabled once at startup, and disabled at exit while other threads
+ * may still be tracing. The flag is an atomic kept in trace.c, so that it's
+ * only ever accessed from C.
+ */
+int trace_is_enabled(void);
+
+/* enables tracing, the trace is written to fname at exit */
+int trace_start(const char *fname);
+void trace_stop(void);
+
+/* names the calling thread in the trace */
+void trace_thread_name(const char *name);
+
+/* names must be string literals, only the pointer is recorded */
+void trace_begin(const char *name);
+void trace_end(void);
+void trace_instant(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define TRACE_BEGIN(name) \
+	do { if(trace_is_enabled()) trace_begin(name); } while(0)
+#define TRACE_END() \
+	do { if(trace_is_enabled()) trace_end(); } while(0)
+#define TRACE_INSTANT(name) \
+	do { if(trace_is_enabled()) trace_instant(name); } while(0)
+
+/* wraps a single statement in a span */
+#define TRACE_CALL(name, stmt) \
+	do { TRACE_BEGIN(name); stmt; TRACE_END(); } while(0)
+
+#ifdef __cplusplus
+/* span for the rest of the enclosing scope */
+class TraceSpan {
+public:
+	explicit TraceSpan(const char *name) { TRACE_BEGIN(name); }
+	~TraceSpan() { TRACE_END(); }
+};
+#endif
+
+#endif	/* TRACE_H_ */
@@ -16,69 +16,232 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #define SPNAV_CONFIG_H_
 #include <spnav.h>
 #include "ui.h"
 #include "spnavcfg.h"
+#include "cfgwr.h"
+#include "cfgcache.h"
 #include "ui_mainwin.h"
-#include "ui_bnmaprow.h"
 #include "ui_about.h"
+#include "meter.h"
+#include "scope.h"
+#include "bnmodel.h"
+#include "evrec.h"
+#include "replay.h"
+#include "perfstat.h"
+#include "perfhud.h"
+#include "calib.h"
+#include "chord.h"
+#include "xform.h"
+#include "profile.h"
+#include "appwatch.h"
+#include "undo.h"
+#include "spnavio.h"
+#include "util.h"
+#include "trace.h"
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImageReader>
+#include <QInputDialog>
 #include <QMessageBox>
-
-#include <X11/Xlib.h>
+#include <QScreen>
+#include <QSocketNotifier>
+#include <QStatusBar>
+#include <QTimer>
+#include <QTreeWidget>
 
 static QSlider *slider_sens_axis[6];
 static QCheckBox *chk_inv[6];
 static QComboBox *combo_axismap[6];
 static QDoubleSpinBox *spin_sens_axis[6];
 static QSpinBox *spin_dead_axis[6];
-static QProgressBar *prog_axis[6];
-static QPixmap *dev_atlas;
-
-static Ui::row_bnmap *bnrow;
-static QVBoxLayout *vbox_bnui;
-static QWidget *bnrow_root;
-static int bnrow_count;
+static AxisMeter *prog_axis[6];
+static QLabel *lb_noise_axis[6];
+
+/* latest motion sample, consumed at most once per frame by frame_update */
+static int motion_val[6];
+static bool motion_dirty;
+static long long motion_wake;	/* socket wakeup which delivered motion_val */
+static int motion_maxval = 256;
+static QTimer *frame_timer;
+
+/* config writes are flushed at most once per FLUSH_INTERVAL msec */
+#define FLUSH_INTERVAL	50
+static QTimer *flush_timer;
+static QElapsedTimer last_flush;
+
+static BnMapModel *bnmodel;
+static QDockWidget *hud_dock;
+
+/* raw axis state, kept current by raw axis events. Deadzone calibration
+ * samples it as a whole on every raw axis event while calibrating.
+ */
+static int raw_axis[MAX_AXES];
+static struct calib_stats calib;
+static bool calibrating, calib_valid;
+
+/* transform preview: raw axis samples go to the raw plot, and through the local
+ * model of the spacenavd transform to the output plot. A sample is taken once
+ * per wakeup, or earlier if an axis changes twice.
+ */
+static struct xform xform;
+static unsigned int raw_touched;
+static int raw_maxval = 256, preview_maxval = 256;
+static ScopeView *scope_raw, *scope_out;
+static const char *raw_axis_names[] = {"axis 0", "axis 1", "axis 2", "axis 3", "axis 4", "axis 5"};
+
+/* button state and chords, with the chord view rows by chord index */
+static struct chord_track chords;
+static QTreeWidgetItem *chord_items[CHORD_MAX];
+
+/* profile entries currently in the profiles menu */
+static QList<QAction*> prof_actions;
+static QString cur_profile;
+/* profile picked by the application watcher, before the device was known */
+static QString app_profile;
+static QSocketNotifier *appwatch_notifier;
 
 static bool mask_events;
 
-static QPalette def_cmb_cmap;
+/* what updateui last put on screen, to only update widgets which changed */
+static struct config shown_cfg;
+static struct device_info shown_dev;
+static bool ui_valid;
+
+/* widget bindings. Each row of axis_bind ties the widgets of one axis (in TX,
+ * TY, TZ, RX, RY, RZ order) to cfg.sens_axis[i], bit i of cfg.invert, the
+ * device axis mapped to i in cfg.map_axis, and cfg.dead_thres[i]. The per-axis
+ * widget arrays above are filled from it, and every widget signal is connected
+ * to a handler which receives the axis index directly.
+ */
+#define AXIS_BINDING(x) \
+	{&Ui::win_main::slider_sens_##x, &Ui::win_main::spin_sens_##x, &Ui::win_main::chk_inv_##x, \
+		&Ui::win_main::combo_axismap_##x, &Ui::win_main::spin_dead_##x, &Ui::win_main::prog_##x, \
+		&Ui::win_main::lb_noise_##x}
+
+static const struct axis_binding {
+	QSlider *Ui::win_main::*slider_sens;
+	QDoubleSpinBox *Ui::win_main::*spin_sens;
+	QCheckBox *Ui::win_main::*chk_inv;
+	QComboBox *Ui::win_main::*combo_axismap;
+	QSpinBox *Ui::win_main::*spin_dead;
+	AxisMeter *Ui::win_main::*meter;
+	QLabel *Ui::win_main::*lb_noise;
+} axis_bind[6] = {
+	AXIS_BINDING(tx), AXIS_BINDING(ty), AXIS_BINDING(tz),
+	AXIS_BINDING(rx), AXIS_BINDING(ry), AXIS_BINDING(rz)
+};
 
+/* checkboxes which map directly to an int config field */
+static const struct opt_binding {
+	QCheckBox *Ui::win_main::*chk;
+	int config::*field;
+	unsigned int flag;
+} chk_bind[] = {
+	{&Ui::win_main::chk_grab, &config::grab, CFG_GRAB},
+	{&Ui::win_main::chk_swapyz, &config::swapyz, CFG_SWAPYZ},
+	{0, 0, 0}
+};
 
-struct device_image {
-	int devtype;
-	int width, height;
-	int xoffs, yoffs;
+/* menu actions, each connected directly to its handler */
+struct act_binding {
+	QAction *Ui::win_main::*act;
+	void (MainWin::*func)();
 };
-static struct device_image devimglist[] = {
-	{SPNAV_DEV_UNKNOWN,		150, 150, 0, 0},
-	{SPNAV_DEV_SB2003,		150, 150, 1, 0},
-	{SPNAV_DEV_SB3003,		150, 150, 2, 0},
-	{SPNAV_DEV_SB4000,		150, 150, 3, 0},
-	{SPNAV_DEV_SM,			150, 150, 5, 0},
-	{SPNAV_DEV_SM5000,		150, 150, 2, 0},
-	{SPNAV_DEV_SMCADMAN,	150, 150, 6, 0},
-	{SPNAV_DEV_PLUSXT,		150, 150, 5, 0},
-	{SPNAV_DEV_CADMAN,		150, 150, 6, 0},
-	{SPNAV_DEV_SMCLASSIC,	150, 150, 4, 0},
-	{SPNAV_DEV_SB5000,		150, 150, 3, 0},
-	{SPNAV_DEV_STRAVEL,		150, 150, 2, 1},
-	{SPNAV_DEV_SPILOT,		150, 150, 3, 1},
-	{SPNAV_DEV_SNAV,		150, 150, 0, 1},
-	{SPNAV_DEV_SEXP,		150, 150, 4, 1},
-	{SPNAV_DEV_SNAVNB,		150, 150, 1, 1},
-	{SPNAV_DEV_SPILOTPRO,	150, 150, 5, 1},
-	{SPNAV_DEV_SMPRO,		150, 150, 6, 1},
-	{SPNAV_DEV_NULOOQ,		150, 150, 7, 0},
-	{SPNAV_DEV_SMW,			150, 150, 1, 2},
-	{SPNAV_DEV_SMPROW,		150, 150, 6, 1},
-	{SPNAV_DEV_SMENT,		150, 150, 7, 1},
-	{SPNAV_DEV_SMCOMP,		150, 150, 0, 2},
-	{SPNAV_DEV_SMMOD,		150, 150, 0, 0},
-	{-1}
+
+const struct act_binding MainWin::act_bind[] = {
+	{&Ui::win_main::act_default, &MainWin::reset_cfg},
+	{&Ui::win_main::act_loadcfg, &MainWin::restore_cfg},
+	{&Ui::win_main::act_savecfg, &MainWin::save_cfg},
+	{&Ui::win_main::act_undo, &MainWin::undo_edit},
+	{&Ui::win_main::act_redo, &MainWin::redo_edit},
+	{&Ui::win_main::act_calib, &MainWin::start_calib},
+	{&Ui::win_main::act_prof_save, &MainWin::save_profile},
+	{&Ui::win_main::act_prof_delete, &MainWin::delete_profile},
+	{&Ui::win_main::act_about, &MainWin::show_about},
+	{0, 0}
 };
 
+/* overloaded signals in Qt5 */
+#define SPIN_VALCHG		static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged)
+#define DSPIN_VALCHG	static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged)
+#define COMBO_IDXCHG	static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged)
+
+
+/* the device atlas is a grid of DEVIMG_SIZE x DEVIMG_SIZE device images. It's
+ * only read when a device is first shown. Qt's PNG reader can't clip, so it's
+ * decoded whole every time a tile is read, and the tiles are kept instead.
+ */
+#define DEVIMG_SIZE	150
+static const char *dev_atlas_path = ":/icons/devices.png";
+static QSize dev_atlas_size;
+
+long long atlas_load_usec;
+
+static void device_tile(int devtype, int *col, int *row)
+{
+#define TILE(c, r)	*col = c; *row = r; break
+
+	switch(devtype) {
+	case SPNAV_DEV_SB2003:		TILE(1, 0);
+	case SPNAV_DEV_SB3003:		TILE(2, 0);
+	case SPNAV_DEV_SB4000:		TILE(3, 0);
+	case SPNAV_DEV_SM:			TILE(5, 0);
+	case SPNAV_DEV_SM5000:		TILE(2, 0);
+	case SPNAV_DEV_SMCADMAN:	TILE(6, 0);
+	case SPNAV_DEV_PLUSXT:		TILE(5, 0);
+	case SPNAV_DEV_CADMAN:		TILE(6, 0);
+	case SPNAV_DEV_SMCLASSIC:	TILE(4, 0);
+	case SPNAV_DEV_SB5000:		TILE(3, 0);
+	case SPNAV_DEV_STRAVEL:		TILE(2, 1);
+	case SPNAV_DEV_SPILOT:		TILE(3, 1);
+	case SPNAV_DEV_SNAV:		TILE(0, 1);
+	case SPNAV_DEV_SEXP:		TILE(4, 1);
+	case SPNAV_DEV_SNAVNB:		TILE(1, 1);
+	case SPNAV_DEV_SPILOTPRO:	TILE(5, 1);
+	case SPNAV_DEV_SMPRO:		TILE(6, 1);
+	case SPNAV_DEV_NULOOQ:		TILE(7, 0);
+	case SPNAV_DEV_SMW:			TILE(1, 2);
+	case SPNAV_DEV_SMPROW:		TILE(6, 1);
+	case SPNAV_DEV_SMENT:		TILE(7, 1);
+	case SPNAV_DEV_SMCOMP:		TILE(0, 2);
+	case SPNAV_DEV_SMMOD:		TILE(0, 0);
+	default:					TILE(0, 0);
+	}
+#undef TILE
+}
+
+static QPixmap device_image(int devtype)
+{
+	/* images, pixmaps can't outlive the application object */
+	static QHash<int, QImage> tiles;
+	int col, row;
+	long long t0 = get_usec();
+
+	device_tile(devtype, &col, &row);
+
+	int ncol = dev_atlas_size.width() / DEVIMG_SIZE;
+	int nrow = dev_atlas_size.height() / DEVIMG_SIZE;
+	int x = col * dev_atlas_size.width() / ncol;
+	int y = row * dev_atlas_size.height() / nrow;
+
+	QImage &img = tiles[row * ncol + col];
+	if(img.isNull()) {
+		QImageReader reader(dev_atlas_path);
+		reader.setClipRect(QRect(x, y, DEVIMG_SIZE, DEVIMG_SIZE));
+		img = reader.read();
+	}
+	QPixmap pix = QPixmap::fromImage(img);
+
+	atlas_load_usec += get_usec() - t0;
+	return pix;
+}
+
 
 MainWin::MainWin(QWidget *par)
 	: QMainWindow(par)
@@ -91,18 +254,19 @@ MainWin::MainWin(QWidget *par)
 
 MainWin::~MainWin()
 {
-	delete [] bnrow_root;
-	delete [] bnrow;
-	delete vbox_bnui;
+	appwatch_stop();
+	cfgwr_flush();
 
 	delete ui;
-	delete dev_atlas;
 }
 
 bool MainWin::init()
 {
-	dev_atlas = new QPixmap(":/icons/devices.png");
-	if(dev_atlas->width() <= 0 || dev_atlas->height() <= 0) {
+	/* only reads the image header */
+	long long t0 = get_usec();
+	dev_atlas_size = QImageReader(dev_atlas_path).size();
+	atlas_load_usec += get_usec() - t0;
+	if(dev_atlas_size.width() < DEVIMG_SIZE || dev_atlas_size.height() < DEVIMG_SIZE) {
 		errorbox("spnavcfg was compiled with corrupted icons/devices.png\n"
 				"\nIf you cloned the git repository, you need to enable GIT-LFS "
 				"and clone again. If you don't want to enable LFS, download the "
@@ -111,59 +275,81 @@ bool MainWin::init()
 		return false;
 	}
 
-	slider_sens_axis[0] = ui->slider_sens_tx;
-	slider_sens_axis[1] = ui->slider_sens_ty;
-	slider_sens_axis[2] = ui->slider_sens_tz;
-	slider_sens_axis[3] = ui->slider_sens_rx;
-	slider_sens_axis[4] = ui->slider_sens_ry;
-	slider_sens_axis[5] = ui->slider_sens_rz;
-
-	chk_inv[0] = ui->chk_inv_tx;
-	chk_inv[1] = ui->chk_inv_ty;
-	chk_inv[2] = ui->chk_inv_tz;
-	chk_inv[3] = ui->chk_inv_rx;
-	chk_inv[4] = ui->chk_inv_ry;
-	chk_inv[5] = ui->chk_inv_rz;
-
-	combo_axismap[0] = ui->combo_axismap_tx;
-	combo_axismap[1] = ui->combo_axismap_ty;
-	combo_axismap[2] = ui->combo_axismap_tz;
-	combo_axismap[3] = ui->combo_axismap_rx;
-	combo_axismap[4] = ui->combo_axismap_ry;
-	combo_axismap[5] = ui->combo_axismap_rz;
-
-	spin_dead_axis[0] = ui->spin_dead_tx;
-	spin_dead_axis[1] = ui->spin_dead_ty;
-	spin_dead_axis[2] = ui->spin_dead_tz;
-	spin_dead_axis[3] = ui->spin_dead_rx;
-	spin_dead_axis[4] = ui->spin_dead_ry;
-	spin_dead_axis[5] = ui->spin_dead_rz;
-
-	spin_sens_axis[0] = ui->spin_sens_tx;
-	spin_sens_axis[1] = ui->spin_sens_ty;
-	spin_sens_axis[2] = ui->spin_sens_tz;
-	spin_sens_axis[3] = ui->spin_sens_rx;
-	spin_sens_axis[4] = ui->spin_sens_ry;
-	spin_sens_axis[5] = ui->spin_sens_rz;
-
-	prog_axis[0] = ui->prog_tx;
-	prog_axis[1] = ui->prog_ty;
-	prog_axis[2] = ui->prog_tz;
-	prog_axis[3] = ui->prog_rx;
-	prog_axis[4] = ui->prog_ry;
-	prog_axis[5] = ui->prog_rz;
-
-	connect(ui->act_default, SIGNAL(triggered()), this, SLOT(act_trig()));
-	connect(ui->act_loadcfg, SIGNAL(triggered()), this, SLOT(act_trig()));
-	connect(ui->act_savecfg, SIGNAL(triggered()), this, SLOT(act_trig()));
-	connect(ui->act_about, SIGNAL(triggered()), this, SLOT(act_trig()));
-
-	connect(ui->combo_led, SIGNAL(currentIndexChanged(int)), this, SLOT(combo_idx_changed(int)));
-	connect(ui->ed_serpath, SIGNAL(editingFinished()), this, SLOT(serpath_changed()));
-	connect(ui->chk_serial, SIGNAL(stateChanged(int)), this, SLOT(chk_changed(int)));
+	for(int i=0; i<6; i++) {
+		const struct axis_binding *bind = axis_bind + i;
+		slider_sens_axis[i] = ui->*bind->slider_sens;
+		spin_sens_axis[i] = ui->*bind->spin_sens;
+		chk_inv[i] = ui->*bind->chk_inv;
+		combo_axismap[i] = ui->*bind->combo_axismap;
+		spin_dead_axis[i] = ui->*bind->spin_dead;
+		prog_axis[i] = ui->*bind->meter;
+		lb_noise_axis[i] = ui->*bind->lb_noise;
+		prog_axis[i]->setRange(motion_maxval);
+	}
+
+	/* pace the axis meters to the display refresh rate. The timer only runs
+	 * while motion events keep arriving, and stops on the first idle frame.
+	 */
+	int frame_msec = 16;
+	QScreen *scr = QGuiApplication::primaryScreen();
+	if(scr && scr->refreshRate() > 1.0) {
+		frame_msec = (int)(1000.0 / scr->refreshRate());
+	}
+	frame_timer = new QTimer(this);
+	frame_timer->setTimerType(Qt::PreciseTimer);
+	frame_timer->setInterval(frame_msec > 0 ? frame_msec : 1);
+	connect(frame_timer, SIGNAL(timeout()), this, SLOT(frame_update()));
+
+	/* motion from the daemon, and next to it the raw input and its preview */
+	scope_raw = ui->scope_raw;
+	scope_out = ui->scope_model;
+	ui->scope->setRange(motion_maxval);
+	scope_raw->setLegend(raw_axis_names);
+	scope_raw->setRange(raw_maxval);
+	scope_out->setRange(preview_maxval);
+	for(ScopeView *scope : {ui->scope, scope_raw, scope_out}) {
+		scope->setFrameInterval(frame_timer->interval());
+		scope->setWindow(ui->spin_scope_window->value());
+		connect(ui->spin_scope_window, SPIN_VALCHG, scope, &ScopeView::setWindow);
+	}
+
+	flush_timer = new QTimer(this);
+	flush_timer->setSingleShot(true);
+	connect(flush_timer, SIGNAL(timeout()), this, SLOT(flush_cfg()));
+	last_flush.start();
+
+	bnmodel = new BnMapModel(this);
+	ui->tbl_buttons->setModel(bnmodel);
+	ui->tbl_buttons->setItemDelegate(new BnMapDelegate(this));
+	ui->tree_chords->sortByColumn(1, Qt::DescendingOrder);
+	connect(ui->bn_clear_chords, &QPushButton::clicked, this, [this] { clear_chords(); });
+
+	hud_dock = new QDockWidget("Performance", this);
+	hud_dock->setObjectName("dock_hud");
+	hud_dock->setWidget(new PerfHud(hud_dock));
+	addDockWidget(Qt::BottomDockWidgetArea, hud_dock);
+	hud_dock->hide();
+	ui->menu_View->addAction(hud_dock->toggleViewAction());
+
+	for(const struct act_binding *bind = act_bind; bind->act; bind++) {
+		connect(ui->*bind->act, &QAction::triggered, this, bind->func);
+	}
+	connect(ui->menu_Edit, &QMenu::aboutToShow, this, [this] {
+		ui->act_undo->setEnabled(cfgwr_pending() || undo_can_undo());
+		ui->act_redo->setEnabled(!cfgwr_pending() && undo_can_redo());
+	});
+	connect(ui->menu_Edit, &QMenu::aboutToHide, this, [this] {
+		/* keep the shortcuts working, undo/redo check for themselves */
+		ui->act_undo->setEnabled(true);
+		ui->act_redo->setEnabled(true);
+	});
+	connect(ui->menu_Profiles, &QMenu::aboutToShow, this, &MainWin::update_profile_menu);
+	connect(ui->act_prof_auto, &QAction::toggled, this, &MainWin::watch_apps);
 
-	connect(ui->chk_repeat, SIGNAL(stateChanged(int)), this, SLOT(chk_changed(int)));
-	connect(ui->spin_repeat, SIGNAL(valueChanged(int)), this, SLOT(spin_changed(int)));
+	connect(ui->ed_serpath, SIGNAL(editingFinished()), this, SLOT(serpath_changed()));
+	connect(ui->chk_serial, &QCheckBox::toggled, this, &MainWin::serial_toggled);
+	connect(ui->chk_repeat, &QCheckBox::toggled, this, &MainWin::repeat_changed);
+	connect(ui->spin_repeat, SPIN_VALCHG, this, &MainWin::repeat_changed);
 
 	/*
 	connect(ui->bn_loaddef, SIGNAL(clicked()), this, SLOT(bn_clicked()));
@@ -171,212 +357,586 @@ bool MainWin::init()
 	connect(ui->bn_savecfg, SIGNAL(clicked()), this, SLOT(bn_clicked()));
 	*/
 
-	connect(ui->chk_grab, SIGNAL(stateChanged(int)), this, SLOT(chk_changed(int)));
-	connect(ui->chk_swapyz, SIGNAL(stateChanged(int)), this, SLOT(chk_changed(int)));
+	for(const struct opt_binding *bind = chk_bind; bind->chk; bind++) {
+		connect(ui->*bind->chk, &QCheckBox::toggled, this, [this, bind](bool on) {
+			opt_changed(bind->field, bind->flag, on);
+		});
+	}
+	connect(ui->combo_led, COMBO_IDXCHG, this, [this](int sel) {
+		opt_changed(&config::led, CFG_LED, sel);
+	});
+
+	connect(ui->slider_sens, &QSlider::valueChanged, this, [this](int val) {
+		sens_changed(-1, val / 10.0f, ui->slider_sens);
+	});
+	connect(ui->spin_sens, DSPIN_VALCHG, this, [this](double val) {
+		sens_changed(-1, val, ui->spin_sens);
+	});
+	connect(ui->spin_dead, SPIN_VALCHG, this, [this](int val) { dead_changed(-1, val); });
 
-	connect(ui->slider_sens, SIGNAL(valueChanged(int)), this, SLOT(slider_changed(int)));
-	connect(ui->spin_sens, SIGNAL(valueChanged(double)), this, SLOT(dspin_changed(double)));
-	connect(ui->spin_dead, SIGNAL(valueChanged(int)), this, SLOT(spin_changed(int)));
 	for(int i=0; i<6; i++) {
-		connect(slider_sens_axis[i], SIGNAL(valueChanged(int)), this, SLOT(slider_changed(int)));
-		connect(spin_sens_axis[i], SIGNAL(valueChanged(double)), this, SLOT(dspin_changed(double)));
-		connect(spin_dead_axis[i], SIGNAL(valueChanged(int)), this, SLOT(spin_changed(int)));
+		connect(slider_sens_axis[i], &QSlider::valueChanged, this, [this, i](int val) {
+			sens_changed(i, val / 10.0f, slider_sens_axis[i]);
+		});
+		connect(spin_sens_axis[i], DSPIN_VALCHG, this, [this, i](double val) {
+			sens_changed(i, val, spin_sens_axis[i]);
+		});
+		connect(spin_dead_axis[i], SPIN_VALCHG, this, [this, i](int val) { dead_changed(i, val); });
+		connect(chk_inv[i], &QCheckBox::toggled, this, [this, i](bool on) { inv_changed(i, on); });
+		connect(combo_axismap[i], COMBO_IDXCHG, this, [this, i](int sel) { axismap_changed(i, sel); });
+	}
+
+	/* the event subscription follows what's on screen */
+	connect(ui->tabWidget_2, &QTabWidget::currentChanged, this, &MainWin::update_evmask);
+	connect(hud_dock, &QDockWidget::visibilityChanged, this, &MainWin::update_evmask);
+	update_evmask();
+
+	return true;
+}
 
-		connect(chk_inv[i], SIGNAL(stateChanged(int)), this, SLOT(chk_changed(int)));
+static bool streq(const char *a, const char *b)
+{
+	if(!a || !b) return a == b;
+	return strcmp(a, b) == 0;
+}
+
+static void set_devinfo_shown(const struct device_info *inf)
+{
+	free(shown_dev.name);
+	free(shown_dev.path);
+	shown_dev = *inf;
+	shown_dev.name = inf->name ? strdup(inf->name) : 0;
+	shown_dev.path = inf->path ? strdup(inf->path) : 0;
+}
 
-		connect(combo_axismap[i], SIGNAL(currentIndexChanged(int)), this, SLOT(combo_idx_changed(int)));
+/* noise labels show the calibration results of the device axis mapped to each
+ * logical axis
+ */
+static void show_noise()
+{
+	for(int i=0; i<6; i++) {
+		int dev = -1;
+		for(int j=0; j<devinfo.naxes; j++) {
+			if(cfg.map_axis[j] == i) dev = j;
+		}
+
+		if(!calib_valid || dev < 0 || dev >= calib.naxes) {
+			lb_noise_axis[i]->setText("-");
+			continue;
+		}
+		lb_noise_axis[i]->setText(QString("\u00b1%1").arg(calib.peak[dev]));
+		lb_noise_axis[i]->setToolTip(QString("Device axis %1 at rest: mean %2, std.dev %3, peak %4 (%5 samples)")
+				.arg(dev).arg(calib.mean[dev], 0, 'f', 2).arg(calib_stddev(&calib, dev), 0, 'f', 2)
+				.arg(calib.peak[dev]).arg(calib.count));
 	}
+}
 
-	return true;
+static void add_preview_sample(long long usec)
+{
+	int outv[6];
+	const int *in[XFORM_AXES];
+	int *out[6];
+
+	for(int i=0; i<XFORM_AXES; i++) {
+		in[i] = raw_axis + i;
+		if(abs(raw_axis[i]) > raw_maxval) {
+			raw_maxval = abs(raw_axis[i]);
+			scope_raw->setRange(raw_maxval);
+		}
+	}
+	for(int i=0; i<6; i++) {
+		out[i] = outv + i;
+	}
+	xform_batch(&xform, in, out, 1);
+
+	for(int i=0; i<6; i++) {
+		if(abs(outv[i]) > preview_maxval) {
+			preview_maxval = abs(outv[i]);
+			scope_out->setRange(preview_maxval);
+		}
+	}
+	scope_raw->add(usec, raw_axis);
+	scope_out->add(usec, outv);
+	raw_touched = 0;
+}
+
+/* re-runs the recorded raw input through the transform when the settings it
+ * depends on change, so that their effect shows over the whole history
+ */
+static void update_preview()
+{
+	struct xform xf;
+
+	xform_setup(&xf, &cfg, devinfo.naxes);
+	if(memcmp(&xf, &xform, sizeof xf) == 0) {
+		return;
+	}
+	xform = xf;
+
+	int peak = scope_out->transform(scope_raw, &xform);
+	preview_maxval = peak > 256 ? peak : 256;
+	scope_out->setRange(preview_maxval);
 }
 
 void MainWin::updateui()
 {
+	TraceSpan span("MainWin::updateui");
+
+	/* only touch widgets whose values differ from what's currently shown */
+	bool full = !ui_valid;
+
 	mask_events = true;
 
-	struct device_image devimg = devimglist[0];
-	for(int i=0; devimglist[i].devtype != -1; i++) {
-		if(devimglist[i].devtype == devinfo.type) {
-			devimg = devimglist[i];
-			break;
-		}
+	if(full || devinfo.type != shown_dev.type) {
+		ui->img_dev->setPixmap(device_image(devinfo.type));
 	}
-	int ncol = dev_atlas->width() / devimg.width;
-	int nrow = dev_atlas->height() / devimg.height;
-	devimg.xoffs = devimg.xoffs * dev_atlas->width() / ncol;
-	devimg.yoffs = devimg.yoffs * dev_atlas->height() / nrow;
 
-	QPixmap pix = dev_atlas->copy(devimg.xoffs, devimg.yoffs, devimg.width, devimg.height);
-	ui->img_dev->setPixmap(pix);
-
-	ui->lb_devname->setText(devinfo.name);
-	ui->lb_devfile->setText(devinfo.path);
-	ui->lb_numaxes->setText(QString::number(devinfo.naxes));
-	ui->lb_numbn->setText(QString::number(devinfo.nbuttons));
+	if(full || !streq(devinfo.name, shown_dev.name)) {
+		ui->lb_devname->setText(devinfo.name);
+	}
+	if(full || !streq(devinfo.path, shown_dev.path)) {
+		ui->lb_devfile->setText(devinfo.path);
+	}
+	bool axes_changed = full || devinfo.naxes != shown_dev.naxes;
+	if(axes_changed) {
+		ui->lb_numaxes->setText(QString::number(devinfo.naxes));
+	}
+	bool bn_changed = full || devinfo.nbuttons != shown_dev.nbuttons;
+	if(bn_changed) {
+		ui->lb_numbn->setText(QString::number(devinfo.nbuttons));
+	}
 
-	ui->combo_led->setCurrentIndex(cfg.led);
-	ui->chk_grab->setChecked(cfg.grab);
-	if(cfg.serdev) {
-		ui->ed_serpath->setText(cfg.serdev);
-		ui->chk_serial->setChecked(true);
-	} else {
-		ui->chk_serial->setChecked(false);
+	if(full || cfg.led != shown_cfg.led) {
+		ui->combo_led->setCurrentIndex(cfg.led);
 	}
-	if(cfg.repeat >= 0) {
-		ui->chk_repeat->setChecked(true);
-		ui->spin_repeat->setValue(cfg.repeat);
-	} else {
-		ui->chk_repeat->setChecked(false);
+	if(full || cfg.grab != shown_cfg.grab) {
+		ui->chk_grab->setChecked(cfg.grab);
+	}
+	if(full || !streq(cfg.serdev, shown_cfg.serdev)) {
+		if(cfg.serdev) {
+			ui->ed_serpath->setText(cfg.serdev);
+			ui->chk_serial->setChecked(true);
+		} else {
+			ui->chk_serial->setChecked(false);
+		}
 	}
+	if(full || cfg.repeat != shown_cfg.repeat) {
+		if(cfg.repeat >= 0) {
+			ui->chk_repeat->setChecked(true);
+			ui->spin_repeat->setValue(cfg.repeat);
+		} else {
+			ui->chk_repeat->setChecked(false);
+		}
+	}
+
+	if(full || cfg.sens != shown_cfg.sens) {
+		ui->slider_sens->setValue(cfg.sens * 10);
+		ui->spin_sens->setValue(cfg.sens);
+	}
+
+	bool axismap_changed = axes_changed ||
+		memcmp(cfg.map_axis, shown_cfg.map_axis, devinfo.naxes * sizeof *cfg.map_axis) != 0 ||
+		memcmp(cfg.dead_thres, shown_cfg.dead_thres, devinfo.naxes * sizeof *cfg.dead_thres) != 0;
 
-	ui->slider_sens->setValue(cfg.sens * 10);
-	ui->spin_sens->setValue(cfg.sens);
 	for(int i=0; i<6; i++) {
-		slider_sens_axis[i]->setValue(cfg.sens_axis[i] * 10);
-		spin_sens_axis[i]->setValue(cfg.sens_axis[i]);
-		chk_inv[i]->setChecked((cfg.invert >> i) & 1);
+		if(full || cfg.sens_axis[i] != shown_cfg.sens_axis[i]) {
+			slider_sens_axis[i]->setValue(cfg.sens_axis[i] * 10);
+			spin_sens_axis[i]->setValue(cfg.sens_axis[i]);
+		}
+		if(full || (((cfg.invert ^ shown_cfg.invert) >> i) & 1)) {
+			chk_inv[i]->setChecked((cfg.invert >> i) & 1);
+		}
 
-		combo_axismap[i]->clear();
-		combo_axismap[i]->addItem("-");
-		for(int j=0; j<devinfo.naxes; j++) {
-			combo_axismap[i]->addItem(QString::number(j));
-			combo_axismap[i]->setCurrentIndex(0);
+		if(axes_changed) {
+			combo_axismap[i]->clear();
+			combo_axismap[i]->addItem("-");
+			for(int j=0; j<devinfo.naxes; j++) {
+				combo_axismap[i]->addItem(QString::number(j));
+			}
 		}
-		for(int j=0; j<devinfo.naxes; j++) {
-			if(cfg.map_axis[j] == i) {
-				combo_axismap[i]->setCurrentIndex(j + 1);
-				spin_dead_axis[i]->setValue(cfg.dead_thres[j]);
+		if(axismap_changed) {
+			int sel = 0;
+			for(int j=0; j<devinfo.naxes; j++) {
+				if(cfg.map_axis[j] == i) {
+					sel = j + 1;
+					spin_dead_axis[i]->setValue(cfg.dead_thres[j]);
+				}
+			}
+			if(combo_axismap[i]->currentIndex() != sel) {
+				combo_axismap[i]->setCurrentIndex(sel);
+			}
+			if(prog_axis[i]->isEnabled() != (sel > 0)) {
+				prog_axis[i]->setValue(0);
+				prog_axis[i]->setEnabled(sel > 0);
 			}
 		}
-
-		prog_axis[i]->setValue(0);
-		prog_axis[i]->setEnabled(1);
 	}
 
-	bool same = true;
-	for(int i=0; i<devinfo.naxes; i++) {
-		if(i > 0 && cfg.dead_thres[i] != cfg.dead_thres[i - 1]) {
-			same = false;
+	if(axismap_changed) {
+		bool same = true;
+		for(int i=0; i<devinfo.naxes; i++) {
+			if(i > 0 && cfg.dead_thres[i] != cfg.dead_thres[i - 1]) {
+				same = false;
+			}
 		}
+
+		ui->spin_dead->setValue(same ? cfg.dead_thres[0] : 0);
+		ui->chk_dead_global->setChecked(same);
+
+		show_noise();
 	}
 
-	ui->spin_dead->setValue(same ? cfg.dead_thres[0] : 0);
-	ui->chk_dead_global->setChecked(same);
+	if(full || cfg.swapyz != shown_cfg.swapyz) {
+		ui->chk_swapyz->setChecked(cfg.swapyz);
+	}
 
-	ui->chk_swapyz->setChecked(cfg.swapyz);
+	// button mapping model, reset only when the number of buttons changes
+	if(bn_changed) {
+		bnmodel->reset();
+		ui->tbl_buttons->resizeColumnsToContents();
+		clear_chords();
+	} else {
+		bnmodel->update(&shown_cfg);
+	}
 
-	// button mapping ui
-	delete [] bnrow_root;
-	delete [] bnrow;
-	delete vbox_bnui;
+	copy_cfg(&shown_cfg, &cfg);
+	set_devinfo_shown(&devinfo);
+	ui_valid = true;
+	update_preview();
 
-	bnrow_count = devinfo.nbuttons;
-	bnrow = new Ui::row_bnmap[bnrow_count];
-	bnrow_root = new QWidget[bnrow_count];
+	mask_events = false;
+}
 
-	vbox_bnui = new QVBoxLayout;
-	ui->scroll_area_buttons_cont->setLayout(vbox_bnui);
+static const char *qtooold_text =
+	"Currently running version of spacenavd is too old for this version of the configuration tool.\n"
+	"\nEither update to a recent version of spacenavd (v0.9 or later), or downgrade to spnavcfg v0.3.1.";
 
-	for(int i=0; i<bnrow_count; i++) {
-		bnrow[i].setupUi(bnrow_root + i);
-		vbox_bnui->addWidget(bnrow_root + i);
+/* set while the window shows the cached state, until the first snapshot */
+static bool cache_shown;
+/* set once the first snapshot arrived */
+static bool started;
 
-		bnrow[i].lb_bidx->setText(QString::asprintf("%02d", i));
-		bnrow[i].spin_bnmap->setMaximum(devinfo.nbuttons - 1);
-		bnrow[i].spin_bnmap->setValue(cfg.map_bn[i]);
+/* paints the last known state of the device from the cache, before the I/O
+ * thread gets to talk to spacenavd. Edits made meanwhile are sent as diffs
+ * against the cached state once connected.
+ */
+bool MainWin::load_cache()
+{
+	TraceSpan span("MainWin::load_cache");
 
-		bnrow[i].cmb_action->setCurrentIndex(cfg.bnact[i]);
-		if(cfg.bnact[i]) {
-			bnrow[i].rad_action->setChecked(true);
-		}
+	if(cache_load(&cfg, &devinfo) == -1) {
+		return false;
+	}
+	cfgwr_sync(&cfg);
+	undo_reset(&cfg);
+	updateui();
 
-		char *str;
-		if(cfg.kbmap[i] > 0 && (str = XKeysymToString(cfg.kbmap[i]))) {
-			bnrow[i].rad_mapkey->setChecked(true);
-			bnrow[i].cmb_mapkey->setCurrentText(str);
+	statusBar()->showMessage("Showing the last known configuration, waiting for spacenavd...");
+	cache_shown = true;
+	return true;
+}
+
+/* picks up status changes and configuration snapshots from the I/O thread */
+void MainWin::io_update()
+{
+	static int prev_status = IO_CONNECTING;
+	static unsigned long reconnects;
+
+	int status = spnavio_status();
+	if(status != prev_status) {
+		prev_status = status;
+		switch(status) {
+		case IO_FAILED:
+			errorbox("Failed to connect to spacenavd!");
+			QCoreApplication::exit(1);
+			return;
+		case IO_TOOOLD:
+			errorbox(qtooold_text);
+			QCoreApplication::exit(1);
+			return;
+		case IO_DISCONNECTED:
+			/* edits made meanwhile are kept, and restored on reconnection */
+			statusBar()->showMessage("Lost the connection to spacenavd, reconnecting...");
+			break;
+		default:
+			break;
 		}
-		bnrow[i].cmb_mapkey->setCompleter(0);
-		def_cmb_cmap = bnrow[i].cmb_mapkey->lineEdit()->palette();
+	}
+
+	struct io_snapshot *snap = spnavio_take_snapshot();
+	if(!snap) return;
 
-		connect(bnrow[i].rad_bnmap, SIGNAL(toggled(bool)), this, SLOT(rad_changed(bool)));
-		connect(bnrow[i].spin_bnmap, SIGNAL(valueChanged(int)), this, SLOT(spin_changed(int)));
-		connect(bnrow[i].rad_action, SIGNAL(toggled(bool)), this, SLOT(rad_changed(bool)));
-		connect(bnrow[i].cmb_action, SIGNAL(currentIndexChanged(int)), this, SLOT(combo_idx_changed(int)));
-		connect(bnrow[i].rad_mapkey, SIGNAL(toggled(bool)), this, SLOT(rad_changed(bool)));
-		connect(bnrow[i].cmb_mapkey, SIGNAL(currentTextChanged(const QString&)), this, SLOT(combo_str_changed(const QString&)));
+	/* local edits go out first. A snapshot taken before the I/O thread got
+	 * to the last of them is stale, and it publishes another after sending
+	 * them, which includes any other changes this one carried.
+	 */
+	cfgwr_flush();
+	if(snap->cmd_seq != spnavio_sent_seq()) {
+		spnavio_free_snapshot(snap);
+		return;
 	}
 
-	mask_events = false;
+	/* reconciling with the cached state keeps the undo history, unless the
+	 * device changed since
+	 */
+	bool keep_undo = started || (cache_shown && cache_same_device(&devinfo, &snap->dev));
+	if(cache_shown) {
+		cache_shown = false;
+		statusBar()->clearMessage();
+	}
+
+	free(devinfo.name);
+	free(devinfo.path);
+	devinfo = snap->dev;
+	snap->dev.name = snap->dev.path = 0;
+	copy_cfg(&cfg, &snap->cfg);
+	fetchstat = snap->fetch;
+
+	if(snap->reconnects != reconnects) {
+		reconnects = snap->reconnects;
+		statusBar()->showMessage(QString("Reconnected to spacenavd in %1 ms")
+				.arg(snap->reconnect_usec / 1000));
+	}
+
+	cfgwr_sync(&cfg);
+	if(!keep_undo) {
+		undo_reset(&cfg);
+	} else {
+		/* changes made by other clients can be undone as well */
+		undo_record(&cfg);
+	}
+	updateui();
+
+	if(!started) {
+		started = true;
+		centralWidget()->setEnabled(true);
+		startup_complete(snap);
+		update_evmask();	/* recording might have started */
+		if(!app_profile.isEmpty()) {
+			apply_app_profile();
+		}
+	}
+	spnavio_free_snapshot(snap);
 }
 
 void MainWin::spnav_input()
 {
 	static int warned_unexp_bnum;
-	static unsigned char bnstate[MAX_BUTTONS];
-	static int maxval = 256;
 	char bnstr[MAX_BUTTONS * 4 + 20];
 	char *endp;
 	spnav_event ev;
-	QLabel *lb;
-	QPalette cmap;
-	static QPalette def_cmap;
+	int nmotion = 0;
+	long long wake = get_usec();
+	bool live = !replay_active();
+	TraceSpan span("MainWin::spnav_input");
+
+	if(live) {
+		spnavio_ack();
+		io_update();
+	}
+
+	while(live ? spnavio_poll_event(&ev) : replay_poll_event(&ev)) {
+		evrec_event(&ev);
+		perf_event(ev.type);
 
-	while(spnav_poll_event(&ev)) {
 		switch(ev.type) {
 		case SPNAV_EVENT_MOTION:
+			/* latest value wins, the meters are updated by frame_update */
 			for(int i=0; i<6; i++) {
-				if(abs(ev.motion.data[i]) > maxval) maxval = abs(ev.motion.data[i]);
+				motion_val[i] = ev.motion.data[i];
+				if(abs(motion_val[i]) > motion_maxval) {
+					motion_maxval = abs(motion_val[i]);
+					ui->scope->setRange(motion_maxval);
+				}
 			}
-			for(int i=0; i<6; i++) {
-				prog_axis[i]->setMinimum(-maxval);
-				prog_axis[i]->setMaximum(maxval);
-				prog_axis[i]->setValue(ev.motion.data[i]);
+			ui->scope->add(wake, motion_val);
+			motion_dirty = true;
+			motion_wake = wake;
+			nmotion++;
+			if(!frame_timer->isActive()) {
+				frame_timer->start();
 			}
 			break;
 
 		case SPNAV_EVENT_RAWBUTTON:
-			if(ev.button.bnum >= bnrow_count) {
+			if(ev.button.bnum >= bnmodel->rowCount()) {
 				if(!warned_unexp_bnum) {
 					warned_unexp_bnum = 1;
 					errorboxf("Received button %d event on a %d button device.\n"
 							"This is a bug. Please report it:\n"
 							"https://github.com/FreeSpacenav/spnavcfg/issues\n"
 							"This warning will only be shown once.",
-							ev.button.bnum, bnrow_count);
+							ev.button.bnum, bnmodel->rowCount());
 				}
 				break;
 			}
-			assert(ev.button.bnum < bnrow_count);
-			lb = bnrow[ev.button.bnum].lb_bidx;
-
-			if(ev.button.press) {
-				bnstate[ev.button.bnum] = 1;
-				def_cmap = cmap = lb->palette();
-				cmap.setColor(QPalette::WindowText, Qt::red);
-				lb->setPalette(cmap);
-			} else {
-				bnstate[ev.button.bnum] = 0;
-				lb->setPalette(def_cmap);
+			assert(ev.button.bnum < bnmodel->rowCount());
+
+			if(!chord_button(&chords, ev.button.bnum, ev.button.press, wake)) {
+				break;	/* repeated press or release */
 			}
+			bnmodel->set_pressed(ev.button.bnum, ev.button.press);
 
 			strcpy(bnstr, "Buttons pressed:");
 			endp = bnstr + strlen(bnstr);
-			for(int i=0; i<devinfo.nbuttons; i++) {
-				if(bnstate[i]) {
-					endp += sprintf(endp, " %02d", i);
-				}
+			for(int i = bnset_next(&chords.down, 0); i != -1; i = bnset_next(&chords.down, i + 1)) {
+				endp += sprintf(endp, " %02d", i);
 			}
 			ui->lb_bnstate->setText(bnstr);
+
+			if(chords.last >= 0) {
+				show_chord(chords.last);
+			}
 			break;
 
-		case SPNAV_EVENT_CFG:
-			read_cfg(&cfg);
+		case SPNAV_EVENT_RAWAXIS:
+			if(ev.axis.idx < 0 || ev.axis.idx >= MAX_AXES) break;
+
+			if(ev.axis.idx < XFORM_AXES) {
+				if(raw_touched & (1 << ev.axis.idx)) {
+					add_preview_sample(wake);
+				}
+				raw_touched |= 1 << ev.axis.idx;
+			}
+			raw_axis[ev.axis.idx] = ev.axis.value;
+
+			if(calibrating && ev.axis.idx < calib.naxes) {
+				calib_sample(&calib, raw_axis);
+			}
 			break;
 
 		default:
 			break;
 		}
 	}
+
+	if(raw_touched) {
+		add_preview_sample(wake);
+	}
+
+	perf_wakeup(nmotion);
+}
+
+void MainWin::show_chord(int idx)
+{
+	const struct chord *c = chords.chords + idx;
+	QString bnlist, holdlist;
+
+	for(int i = bnset_next(&c->set, 0); i != -1; i = bnset_next(&c->set, i + 1)) {
+		if(!bnlist.isEmpty()) {
+			bnlist += " + ";
+			holdlist += " / ";
+		}
+		bnlist += QString::asprintf("%02d", i);
+		holdlist += QString::number(c->hold_msec[i]);
+	}
+
+	QTreeWidgetItem *item = chord_items[idx];
+	if(!item) {
+		item = chord_items[idx] = new QTreeWidgetItem(ui->tree_chords);
+	}
+	/* the view is sorted, keep it from reordering rows while we fill one in */
+	ui->tree_chords->setSortingEnabled(false);
+	item->setText(0, bnlist);
+	item->setData(1, Qt::DisplayRole, (qulonglong)c->count);
+	item->setText(2, holdlist);
+	ui->tree_chords->setSortingEnabled(true);
+}
+
+void MainWin::clear_chords()
+{
+	chord_reset(&chords);
+	ui->tree_chords->clear();
+	memset(chord_items, 0, sizeof chord_items);
+	ui->lb_bnstate->setText("Buttons pressed:");
+}
+
+/* input events are only subscribed to while something needs them: motion for
+ * the axis meters, the performance panel and the monitor tab, raw axes for the
+ * monitor tab and calibration, raw buttons for the button tab. A recording
+ * gets everything.
+ */
+void MainWin::update_evmask()
+{
+	static unsigned int prev_mask = SPNAV_EVMASK_ALL;
+	unsigned int mask = 0;
+
+	if(!hud_dock) return;	/* shown before init, which calls us when done */
+
+	if(evrec_active()) {
+		mask = SPNAV_EVMASK_ALL;
+	} else {
+		if(isVisible() && !isMinimized()) {
+			QWidget *tab = ui->tabWidget_2->currentWidget();
+			if(tab == ui->tab_axes || tab == ui->tab_monitor || hud_dock->isVisible()) {
+				mask |= SPNAV_EVMASK_MOTION;
+			}
+			if(tab == ui->tab_monitor) {
+				mask |= SPNAV_EVMASK_RAWAXIS;
+			}
+			if(tab == ui->tab_buttons) {
+				mask |= SPNAV_EVMASK_RAWBUTTON;
+			}
+		}
+		if(calibrating) {
+			mask |= SPNAV_EVMASK_RAWAXIS;
+		}
+	}
+
+	if((prev_mask & SPNAV_EVMASK_MOTION) && !(mask & SPNAV_EVMASK_MOTION)) {
+		/* don't leave the meters stuck where the last event left them */
+		memset(motion_val, 0, sizeof motion_val);
+		motion_dirty = true;
+		if(!frame_timer->isActive()) {
+			frame_timer->start();
+		}
+	}
+	prev_mask = mask;
+	spnavio_set_evmask(mask);
+}
+
+void MainWin::changeEvent(QEvent *ev)
+{
+	if(ev->type() == QEvent::WindowStateChange) {
+		update_evmask();
+	}
+	QMainWindow::changeEvent(ev);
+}
+
+void MainWin::showEvent(QShowEvent *ev)
+{
+	QMainWindow::showEvent(ev);
+	update_evmask();
+}
+
+void MainWin::hideEvent(QHideEvent *ev)
+{
+	QMainWindow::hideEvent(ev);
+	update_evmask();
+}
+
+void MainWin::show_hud(bool show)
+{
+	hud_dock->setVisible(show);
+}
+
+void MainWin::frame_update()
+{
+	if(!motion_dirty) {
+		frame_timer->stop();
+		return;
+	}
+	motion_dirty = false;
+	perf_frame(motion_wake);
+
+	for(int i=0; i<6; i++) {
+		if(prog_axis[i]->range() != motion_maxval) {
+			prog_axis[i]->setRange(motion_maxval);
+		}
+		if(prog_axis[i]->isEnabled()) {
+			prog_axis[i]->setValue(motion_val[i]);
+		}
+	}
 }
 
 static const char *qdefaults_text =
@@ -389,180 +949,319 @@ static const char *qsave_text =
 	"Saving will overwrite the current spacenavd configuration file.\n"
 	"Are you sure you want to proceed?";
 
-void MainWin::act_trig()
+void MainWin::reset_cfg()
 {
-	QObject *src = QObject::sender();
-	if(src == ui->act_default) {
-		if(QMessageBox::question(this, "Reset defaults?", qdefaults_text) == QMessageBox::Yes) {
-			spnav_cfg_reset();
-			read_cfg(&cfg);
-		}
-	} else if(src == ui->act_loadcfg) {
-		if(QMessageBox::question(this, "Restore configuration?", qload_text) == QMessageBox::Yes) {
-			spnav_cfg_restore();
-			read_cfg(&cfg);
-		}
-	} else if(src == ui->act_savecfg) {
-		if(QMessageBox::question(this, "Save configuration?", qsave_text) == QMessageBox::Yes) {
-			spnav_cfg_save();
-		}
-	} else if(src == ui->act_about) {
-		aboutbox();
+	if(QMessageBox::question(this, "Reset defaults?", qdefaults_text) == QMessageBox::Yes) {
+		cfgwr_flush();
+		spnavio_command(IO_CMD_RESET);
 	}
 }
 
-void MainWin::slider_changed(int val)
+void MainWin::restore_cfg()
 {
-	if(mask_events) return;
+	if(QMessageBox::question(this, "Restore configuration?", qload_text) == QMessageBox::Yes) {
+		cfgwr_flush();
+		spnavio_command(IO_CMD_RESTORE);
+	}
+}
 
-	QObject *src = QObject::sender();
-	if(src == ui->slider_sens) {
-		cfg.sens = val / 10.0f;
-		ui->spin_sens->setValue(cfg.sens);
-		spnav_cfg_set_sens(cfg.sens);
+void MainWin::save_cfg()
+{
+	if(QMessageBox::question(this, "Save configuration?", qsave_text) == QMessageBox::Yes) {
+		cfgwr_flush();
+		spnavio_command(IO_CMD_SAVE);
+	}
+}
+
+/* pending edits become the latest undo step first */
+void MainWin::undo_edit()
+{
+	cfgwr_flush();
+	if(undo() == -1) {
+		statusBar()->showMessage("Nothing to undo", 2000);
 		return;
 	}
+	last_flush.restart();
+	updateui();
+}
 
-	for(int i=0; i<6; i++) {
-		if(src == slider_sens_axis[i]) {
-			cfg.sens_axis[i] = val / 10.0f;
-			spin_sens_axis[i]->setValue(cfg.sens_axis[i]);
-			spnav_cfg_set_axis_sens(cfg.sens_axis);
-			return;
-		}
+void MainWin::redo_edit()
+{
+	cfgwr_flush();
+	if(redo() == -1) {
+		statusBar()->showMessage("Nothing to redo", 2000);
+		return;
 	}
+	last_flush.restart();
+	updateui();
 }
 
-void MainWin::dspin_changed(double val)
+void MainWin::show_about()
 {
-	if(mask_events) return;
+	aboutbox();
+}
 
-	QObject *src = QObject::sender();
-	if(src == ui->spin_sens) {
-		cfg.sens = val;
-		ui->slider_sens->setValue(val * 10.0f);
-		spnav_cfg_set_sens(cfg.sens);
+void MainWin::update_profile_menu()
+{
+	int count;
+	char **names = profile_list(&count);
+
+	for(QAction *act : prof_actions) {
+		ui->menu_Profiles->removeAction(act);
+		delete act;
+	}
+	prof_actions.clear();
+
+	for(int i=0; i<count; i++) {
+		QString name = QString::fromUtf8(names[i]);
+		QAction *act = ui->menu_Profiles->addAction(name);
+		act->setCheckable(true);
+		act->setChecked(name == cur_profile);
+		connect(act, &QAction::triggered, this, [this, name] { switch_profile(name); });
+		prof_actions.append(act);
+	}
+	profile_free_list(names, count);
+
+	ui->act_prof_delete->setEnabled(count > 0);
+}
+
+void MainWin::switch_profile(const QString &name)
+{
+	int nreq = profile_switch(name.toUtf8().data());
+	if(nreq == -1) {
+		errorboxf("Failed to load profile: %s", name.toUtf8().data());
 		return;
 	}
+	cur_profile = name;
+	last_flush.restart();
+	updateui();
+	statusBar()->showMessage(QString("Switched to profile %1 (%2 changes sent)").arg(name).arg(nreq), 5000);
+}
 
-	for(int i=0; i<6; i++) {
-		if(src == spin_sens_axis[i]) {
-			cfg.sens_axis[i] = val;
-			slider_sens_axis[i]->setValue(val * 10.0f);
-			spnav_cfg_set_axis_sens(cfg.sens_axis);
-			return;
-		}
+void MainWin::watch_apps(bool on)
+{
+	if(on == appwatch_active()) return;
+
+	if(!on) {
+		delete appwatch_notifier;
+		appwatch_notifier = 0;
+		appwatch_stop();
+		return;
 	}
+
+	int fd = appwatch_start();
+	if(fd == -1) {
+		errorbox("Failed to start following the focused application.\n"
+				"Per-application profiles need X11, and rules in ~/.config/spnavcfg/apps.conf");
+		QSignalBlocker block(ui->act_prof_auto);
+		ui->act_prof_auto->setChecked(false);
+		return;
+	}
+	appwatch_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+	connect(appwatch_notifier, &QSocketNotifier::activated, this, &MainWin::appwatch_input);
+
+	QSignalBlocker block(ui->act_prof_auto);
+	ui->act_prof_auto->setChecked(true);
 }
 
-void MainWin::spin_changed(int val)
+/* the watcher thread only names the profile, it's loaded here by
+ * apply_app_profile, and only the changed fields are sent
+ */
+void MainWin::appwatch_input()
 {
-	if(mask_events) return;
+	char name[256];
 
-	QObject *src = QObject::sender();
+	if(appwatch_poll(name, sizeof name) == -1) {
+		return;
+	}
+	/* profiles are read against the device info, wait for the first snapshot */
+	app_profile = QString::fromUtf8(name);
+	if(started) {
+		apply_app_profile();
+	}
+}
 
-	if(src == ui->spin_repeat) {
-		cfg.repeat = ui->spin_repeat->value();
-		spnav_cfg_set_repeat(cfg.repeat);
+void MainWin::apply_app_profile()
+{
+	QString name = app_profile;
+	app_profile.clear();
+
+	int nreq = profile_switch(name.toUtf8().data());
+	if(nreq == -1) {
+		statusBar()->showMessage(QString("Failed to load profile %1").arg(name), 5000);
 		return;
 	}
+	cur_profile = name;
+	last_flush.restart();
+	updateui();
+	statusBar()->showMessage(QString("Switched to profile %1 (%2 changes sent)").arg(cur_profile).arg(nreq), 5000);
+}
 
-	if(src == ui->spin_dead) {
-		for(int i=0; i<devinfo.naxes; i++) {
-			if(cfg.dead_thres[i] != val) {
-				cfg.dead_thres[i] = val;
-				spnav_cfg_set_deadzone(i, val);
-			}
-		}
+void MainWin::save_profile()
+{
+	bool ok;
+	QString name = QInputDialog::getText(this, "Save profile", "Profile name:", QLineEdit::Normal,
+			cur_profile, &ok);
+	if(!ok || name.isEmpty()) return;
+
+	if(!profile_valid_name(name.toUtf8().data())) {
+		errorbox("Profile names can't contain slashes, or start with a dot.");
 		return;
 	}
+	cfgwr_flush();
+	if(profile_save(name.toUtf8().data(), &cfg, &devinfo) == -1) {
+		errorboxf("Failed to save profile: %s", name.toUtf8().data());
+		return;
+	}
+	cur_profile = name;
+}
 
-	for(int i=0; i<6; i++) {
-		if(src == spin_dead_axis[i]) {
-			cfg.dead_thres[i] = val;
-			spnav_cfg_set_deadzone(i, val);
-			return;
-		}
+void MainWin::delete_profile()
+{
+	int count;
+	char **names = profile_list(&count);
+	QStringList list;
+	for(int i=0; i<count; i++) {
+		list << QString::fromUtf8(names[i]);
+	}
+	profile_free_list(names, count);
+	if(list.isEmpty()) return;
+
+	bool ok;
+	QString name = QInputDialog::getItem(this, "Delete profile", "Profile to delete:", list,
+			qMax(list.indexOf(cur_profile), 0), false, &ok);
+	if(!ok) return;
+
+	if(profile_remove(name.toUtf8().data()) == -1) {
+		errorboxf("Failed to delete profile: %s", name.toUtf8().data());
+		return;
+	}
+	if(name == cur_profile) {
+		cur_profile.clear();
 	}
 }
 
+static const char *qcalib_text =
+	"Deadzone calibration measures the noise of each device axis at rest.\n"
+	"Let go of the device, and keep it still for a few seconds after pressing OK.";
 
-void MainWin::chk_changed(int checked)
+void MainWin::start_calib()
 {
-	if(mask_events) return;
+	if(calibrating) return;
 
-	QObject *src = QObject::sender();
-	if(src == ui->chk_grab) {
-		cfg.grab = checked;
-		spnav_cfg_set_grab(checked);
+	if(QMessageBox::information(this, "Calibrate deadzones", qcalib_text,
+				QMessageBox::Ok | QMessageBox::Cancel) != QMessageBox::Ok) {
 		return;
 	}
 
-	if(src == ui->chk_serial) {
-		free(cfg.serdev);
-		cfg.serdev = 0;
-		spnav_cfg_set_serial(cfg.serdev);
+	/* raw axes might not have been subscribed to, and at rest they're close
+	 * enough to zero until they report in
+	 */
+	memset(raw_axis, 0, sizeof raw_axis);
+	calib_begin(&calib, devinfo.naxes);
+	calibrating = true;
+	update_evmask();
+	ui->act_calib->setEnabled(false);
+	statusBar()->showMessage("Calibrating, keep the device still...");
+
+	QTimer::singleShot(CALIB_MSEC, this, [this] { finish_calib(); });
+}
+
+void MainWin::finish_calib()
+{
+	calibrating = false;
+	update_evmask();
+	ui->act_calib->setEnabled(true);
+	statusBar()->clearMessage();
+
+	if(!calib.count) {
+		/* devices only report changes, a perfectly quiet one sends nothing */
+		QMessageBox::information(this, "Calibrate deadzones", "No raw axis input was received during "
+				"calibration, the device appears to have no noise at rest.\nThe deadzones were left unchanged.");
 		return;
 	}
+	calib_valid = true;
+	show_noise();
+
+	int dz[MAX_AXES];
+	QString msg = "Proposed deadzones:\n";
+	for(int i=0; i<calib.naxes; i++) {
+		dz[i] = calib_deadzone(&calib, i);
+		msg += QString("\naxis %1: %2 (currently %3)").arg(i).arg(dz[i]).arg(cfg.dead_thres[i]);
+	}
+	msg += "\n\nApply them?";
 
-	if(src == ui->chk_repeat) {
-		if(checked) {
-			cfg.repeat = ui->spin_repeat->value();
-		} else {
-			cfg.repeat = -1;
-		}
-		spnav_cfg_set_repeat(cfg.repeat);
+	if(QMessageBox::question(this, "Calibrate deadzones", msg) == QMessageBox::Yes) {
+		memcpy(cfg.dead_thres, dz, calib.naxes * sizeof *dz);
+		cfgwr_touch(CFG_DEADZONE);
+		updateui();
 	}
+}
 
-	if(src == ui->chk_swapyz) {
-		cfg.swapyz = checked;
-		spnav_cfg_set_swapyz(checked);
-		return;
+/* axis -1 is the global sensitivity, src is the widget which changed, and
+ * the other one of the slider/spinbox pair is updated to match.
+ */
+void MainWin::sens_changed(int axis, float val, QObject *src)
+{
+	TraceSpan span("MainWin::sens_changed");
+
+	if(mask_events) return;
+
+	QSlider *slider = axis < 0 ? ui->slider_sens : slider_sens_axis[axis];
+	QDoubleSpinBox *spin = axis < 0 ? ui->spin_sens : spin_sens_axis[axis];
+
+	if(src == slider) {
+		QSignalBlocker block(spin);
+		spin->setValue(val);
+	} else {
+		QSignalBlocker block(slider);
+		slider->setValue(val * 10.0f);
 	}
 
-	for(int i=0; i<6; i++) {
-		if(src == chk_inv[i]) {
-			if(checked) {
-				cfg.invert |= 1 << i;
-			} else {
-				cfg.invert &= ~(1 << i);
-			}
-			spnav_cfg_set_invert(cfg.invert);
-			return;
-		}
+	unsigned int flag = axis < 0 ? CFG_SENS : CFG_SENS_AXIS;
+	if(axis < 0) {
+		cfg.sens = val;
+	} else {
+		cfg.sens_axis[axis] = val;
 	}
+	mark_shown(flag);
+	cfgwr_touch(flag);
+	update_preview();
 }
 
-void MainWin::rad_changed(bool active)
+/* axis -1 sets the same deadzone on all device axes */
+void MainWin::dead_changed(int axis, int val)
 {
+	TraceSpan span("MainWin::dead_changed");
+
 	if(mask_events) return;
 
-	QObject *src = QObject::sender();
-	for(int i=0; i<bnrow_count; i++) {
-		if(src == bnrow[i].rad_bnmap) {
-			if(!active) return;
-			spnav_cfg_set_bnmap(i, cfg.map_bn[i]);
-			return;
-		}
-		if(src == bnrow[i].rad_action) {
-			if(active) {
-				spnav_cfg_set_bnaction(i, cfg.bnact[i]);
-			} else {
-				spnav_cfg_set_bnaction(i, SPNAV_BNACT_NONE);
-			}
-			return;
-		}
-		if(src == bnrow[i].rad_mapkey) {
-			if(active) {
-				if(cfg.kbmap[i]) {
-					spnav_cfg_set_kbmap(i, cfg.kbmap[i]);
-				}
-			} else {
-				spnav_cfg_set_kbmap(i, 0);
-			}
-			return;
+	if(axis < 0) {
+		for(int i=0; i<devinfo.naxes; i++) {
+			cfg.dead_thres[i] = val;
 		}
+	} else {
+		cfg.dead_thres[axis] = val;
+	}
+	cfgwr_touch(CFG_DEADZONE);
+	/* the other deadzone spinboxes follow */
+	updateui();
+}
+
+void MainWin::inv_changed(int axis, bool inv)
+{
+	TraceSpan span("MainWin::inv_changed");
+
+	if(mask_events) return;
+
+	if(inv) {
+		cfg.invert |= 1 << axis;
+	} else {
+		cfg.invert &= ~(1 << axis);
 	}
+	mark_shown(CFG_INVERT);
+	cfgwr_touch(CFG_INVERT);
+	update_preview();
 }
 
 static void unmap_axis(int axis, int skip_devaxis)
@@ -571,105 +1270,127 @@ static void unmap_axis(int axis, int skip_devaxis)
 		if(skip_devaxis == i) continue;
 		if(cfg.map_axis[i] == axis) {
 			cfg.map_axis[i] = -1;
-			spnav_cfg_set_axismap(i, -1);
 		}
 	}
 }
 
-void MainWin::combo_idx_changed(int sel)
+void MainWin::axismap_changed(int axis, int sel)
 {
-	if(mask_events) return;
-
-	QObject *src = QObject::sender();
-	if(src == ui->combo_led) {
-		cfg.led = sel;
-		spnav_cfg_set_led(sel);
-		return;
-	}
+	TraceSpan span("MainWin::axismap_changed");
 
-	for(int i=0; i<6; i++) {
-		if(src == combo_axismap[i]) {
-			int devaxis = sel - 1;
+	if(mask_events) return;
 
-			if(devaxis < 0) {
-				unmap_axis(i, -1);
-				prog_axis[i]->setEnabled(0);
-				prog_axis[i]->setValue(0);
-			} else {
-				unmap_axis(i, devaxis);
-				cfg.map_axis[devaxis] = i;
-				spnav_cfg_set_axismap(devaxis, i);
-
-				for(int j=0; j<6; j++) {
-					if(j != i && combo_axismap[j]->currentIndex() == sel) {
-						mask_events = true;
-						combo_axismap[j]->setCurrentIndex(0);
-						prog_axis[j]->setEnabled(0);
-						prog_axis[j]->setValue(0);
-						mask_events = false;
-					}
-				}
+	int devaxis = sel - 1;
 
-				if(!prog_axis[i]->isEnabled()) {
-					prog_axis[i]->setEnabled(1);
-				}
+	if(devaxis < 0) {
+		unmap_axis(axis, -1);
+		prog_axis[axis]->setEnabled(0);
+		prog_axis[axis]->setValue(0);
+	} else {
+		unmap_axis(axis, devaxis);
+		cfg.map_axis[devaxis] = axis;
+
+		for(int j=0; j<6; j++) {
+			if(j != axis && combo_axismap[j]->currentIndex() == sel) {
+				mask_events = true;
+				combo_axismap[j]->setCurrentIndex(0);
+				prog_axis[j]->setEnabled(0);
+				prog_axis[j]->setValue(0);
+				mask_events = false;
 			}
-			return;
 		}
-	}
 
-	for(int i=0; i<bnrow_count; i++) {
-		if(src == bnrow[i].cmb_action) {
-			cfg.bnact[i] = bnrow[i].cmb_action->currentIndex();
-			spnav_cfg_set_bnaction(i, cfg.bnact[i]);
-			return;
+		if(!prog_axis[axis]->isEnabled()) {
+			prog_axis[axis]->setEnabled(1);
 		}
 	}
+	cfgwr_touch(CFG_AXISMAP);
+	/* the deadzone of the newly mapped device axis follows */
+	updateui();
 }
 
-void MainWin::combo_str_changed(const QString &qstr)
+void MainWin::opt_changed(int config::*field, unsigned int flag, int val)
 {
-	const char *str;
+	TraceSpan span("MainWin::opt_changed");
 
 	if(mask_events) return;
 
-	QObject *src = QObject::sender();
-	for(int i=0; i<bnrow_count; i++) {
-		if(src == bnrow[i].cmb_mapkey) {
-			str = qstr.toLatin1().data();
-			if(!str || !*str) return;
-
-			QLineEdit *ed = bnrow[i].cmb_mapkey->lineEdit();
-			KeySym sym = XStringToKeysym(str);
-			if(sym == NoSymbol) {
-				QPalette cmap = def_cmb_cmap;
-				cmap.setColor(QPalette::Text, Qt::red);
-				ed->setPalette(cmap);
-				return;
-			}
-			ed->setPalette(def_cmb_cmap);
+	cfg.*field = val;
+	mark_shown(flag);
+	cfgwr_touch(flag);
+	update_preview();
+}
 
-			cfg.kbmap[i] = sym;
-			spnav_cfg_set_kbmap(i, cfg.kbmap[i]);
-			return;
-		}
-	}
+void MainWin::repeat_changed()
+{
+	TraceSpan span("MainWin::repeat_changed");
+
+	if(mask_events) return;
+
+	cfg.repeat = ui->chk_repeat->isChecked() ? ui->spin_repeat->value() : -1;
+	mark_shown(CFG_REPEAT);
+	cfgwr_touch(CFG_REPEAT);
+}
+
+void MainWin::serial_toggled(bool on)
+{
+	TraceSpan span("MainWin::serial_toggled");
+
+	if(mask_events || on) return;
+
+	free(cfg.serdev);
+	cfg.serdev = 0;
+	mark_shown(CFG_SERIAL);
+	cfgwr_touch(CFG_SERIAL);
+	cfgwr_flush();
+}
+
+void MainWin::flush_cfg()
+{
+	TraceSpan span("MainWin::flush_cfg");
+
+	cfgwr_flush();
+	last_flush.restart();
 }
 
 void MainWin::serpath_changed()
 {
+	TraceSpan span("MainWin::serpath_changed");
+
 	free(cfg.serdev);
 	cfg.serdev = strdup(ui->ed_serpath->text().toUtf8().data());
 
 	if(cfg.serdev) {
-		spnav_cfg_set_serial(cfg.serdev);
-		read_cfg(&cfg);
+		mark_shown(CFG_SERIAL);
+		cfgwr_touch(CFG_SERIAL);
+		cfgwr_flush();
 	}
 }
 
 extern "C" void update_ui(void)
 {
-	mainwin->updateui();
+	if(mainwin) {
+		mainwin->updateui();
+	}
+}
+
+/* a widget the user edited already shows the new value, and later updates
+ * have to compare against it, or reverting to the old value would be missed
+ */
+extern "C" void mark_shown(unsigned int fields)
+{
+	if(ui_valid) {
+		merge_cfg(&shown_cfg, &cfg, fields);
+	}
+}
+
+extern "C" void schedule_cfg_flush(void)
+{
+	if(flush_timer->isActive()) return;
+
+	/* flush on the next event loop iteration, unless we've flushed recently */
+	qint64 dt = last_flush.elapsed();
+	flush_timer->start(dt >= FLUSH_INTERVAL ? 0 : FLUSH_INTERVAL - dt);
 }
 
 extern "C" void errorbox(const char *msg)
@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QMainWindow>
 
+struct config;
+struct io_snapshot;
+struct act_binding;
+
 namespace Ui {
 	class win_main;
 }
@@ -32,33 +36,75 @@ class MainWin : public QMainWindow {
 private:
 	Ui::win_main *ui;
 
+	void sens_changed(int axis, float val, QObject *src);
+	void dead_changed(int axis, int val);
+	void inv_changed(int axis, bool inv);
+	void axismap_changed(int axis, int sel);
+	void opt_changed(int config::*field, unsigned int flag, int val);
+	void repeat_changed();
+	void serial_toggled(bool on);
+
+	void io_update();
+
+	/* menu actions, each connected straight to its handler */
+	static const struct act_binding act_bind[];
+	void reset_cfg();
+	void restore_cfg();
+	void save_cfg();
+	void undo_edit();
+	void redo_edit();
+	void show_about();
+
+	void start_calib();
+	void finish_calib();
+
+	void show_chord(int idx);
+	void clear_chords();
+
+	void update_evmask();
+
+protected:
+	void changeEvent(QEvent *ev);
+	void showEvent(QShowEvent *ev);
+	void hideEvent(QHideEvent *ev);
+
+	void switch_profile(const QString &name);
+	void apply_app_profile();
+	void save_profile();
+	void delete_profile();
+
 public:
 	explicit MainWin(QWidget *par = 0);
 	~MainWin();
 
 	bool init();
+	bool load_cache();
 	void updateui();
+	void show_hud(bool show);
 
 public slots:
 	void spnav_input();
+	void frame_update();
+	void flush_cfg();
 
-	void act_trig();
-	void slider_changed(int val);
-	void dspin_changed(double val);
-	void spin_changed(int val);
-	void chk_changed(int checked);
-	void rad_changed(bool active);
-	void combo_idx_changed(int sel);
-	void combo_str_changed(const QString &qstr);
+	void update_profile_menu();
+	void watch_apps(bool on);
+	void appwatch_input();
 	void serpath_changed();
 };
 
 extern MainWin *mainwin;
+extern long long atlas_load_usec;
+
+/* called when the first configuration snapshot arrives from the I/O thread */
+void startup_complete(const struct io_snapshot *snap);
 
 extern "C" {
 #endif
 
 void update_ui(void);
+void mark_shown(unsigned int fields);
+void schedule_cfg_flush(void);
 void errorbox(const char *msg);
 void errorboxf(const char *fmt, ...);
 void aboutbox(void);
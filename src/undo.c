@@ -0,0 +1,314 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "undo.h"
+#include "cfgwr.h"
+#include "util.h"
+
+#define CHUNK_SIZE	16
+#define NUM_CHUNKS	(MAX_BUTTONS / CHUNK_SIZE)
+
+#if MAX_AXES != MAX_BUTTONS
+#error "undo assumes per-axis and per-button arrays of the same size"
+#endif
+
+struct chunk {
+	int refcnt;
+	int data[CHUNK_SIZE];
+};
+
+enum { ARR_AXISMAP, ARR_DEADZONE, ARR_BNMAP, ARR_BNACT, ARR_KBMAP, NUM_ARRAYS };
+
+static const unsigned int arr_flag[NUM_ARRAYS] = {
+	CFG_AXISMAP, CFG_DEADZONE, CFG_BNMAP, CFG_BNACT, CFG_KBMAP
+};
+
+struct state {
+	float sens, sens_axis[6];
+	int invert, swapyz, led, grab, repeat;
+	char *serdev;
+	struct chunk *chunk[NUM_ARRAYS][NUM_CHUNKS];
+
+	unsigned int fields;	/* fields which differ from the previous state */
+	long long usec;
+};
+
+static struct state *hist[UNDO_MAX_DEPTH];
+static int nhist, cur;
+/* set while undo/redo flush their own changes */
+static int replaying;
+
+static int *cfg_array(const struct config *cfg, int arr)
+{
+	struct config *c = (struct config*)cfg;
+
+	switch(arr) {
+	case ARR_AXISMAP:	return c->map_axis;
+	case ARR_DEADZONE:	return c->dead_thres;
+	case ARR_BNMAP:		return c->map_bn;
+	case ARR_BNACT:		return c->bnact;
+	case ARR_KBMAP:		return c->kbmap;
+	default:
+		break;
+	}
+	return 0;
+}
+
+static int streq(const char *a, const char *b)
+{
+	if(!a || !b) return a == b;
+	return strcmp(a, b) == 0;
+}
+
+static void free_state(struct state *st)
+{
+	int i, j;
+
+	if(!st) return;
+
+	for(i=0; i<NUM_ARRAYS; i++) {
+		for(j=0; j<NUM_CHUNKS; j++) {
+			if(--st->chunk[i][j]->refcnt <= 0) {
+				free(st->chunk[i][j]);
+			}
+		}
+	}
+	free(st->serdev);
+	free(st);
+}
+
+/* builds a state from cfg, sharing every chunk which is unchanged from prev */
+static struct state *make_state(const struct config *cfg, const struct state *prev)
+{
+	int i, j;
+	struct state *st;
+	struct chunk *ch;
+	const int *src;
+
+	if(!(st = calloc(1, sizeof *st))) {
+		return 0;
+	}
+	st->sens = cfg->sens;
+	memcpy(st->sens_axis, cfg->sens_axis, sizeof st->sens_axis);
+	st->invert = cfg->invert;
+	st->swapyz = cfg->swapyz;
+	st->led = cfg->led;
+	st->grab = cfg->grab;
+	st->repeat = cfg->repeat;
+	st->serdev = cfg->serdev ? strdup(cfg->serdev) : 0;
+
+	for(i=0; i<NUM_ARRAYS; i++) {
+		src = cfg_array(cfg, i);
+		for(j=0; j<NUM_CHUNKS; j++, src += CHUNK_SIZE) {
+			if(prev && memcmp(prev->chunk[i][j]->data, src, sizeof ch->data) == 0) {
+				ch = prev->chunk[i][j];
+			} else {
+				if(!(ch = malloc(sizeof *ch))) {
+					st->chunk[i][j] = 0;
+					goto err;
+				}
+				ch->refcnt = 0;
+				memcpy(ch->data, src, sizeof ch->data);
+			}
+			ch->refcnt++;
+			st->chunk[i][j] = ch;
+		}
+	}
+	return st;
+
+err:
+	/* release the chunks acquired so far */
+	for(i=0; i<NUM_ARRAYS; i++) {
+		for(j=0; j<NUM_CHUNKS; j++) {
+			if(!st->chunk[i][j]) goto done;
+			if(--st->chunk[i][j]->refcnt <= 0) {
+				free(st->chunk[i][j]);
+			}
+		}
+	}
+done:
+	free(st->serdev);
+	free(st);
+	return 0;
+}
+
+static void restore_state(struct config *cfg, const struct state *st)
+{
+	int i, j;
+	int *dst;
+
+	cfg->sens = st->sens;
+	memcpy(cfg->sens_axis, st->sens_axis, sizeof cfg->sens_axis);
+	cfg->invert = st->invert;
+	cfg->swapyz = st->swapyz;
+	cfg->led = st->led;
+	cfg->grab = st->grab;
+	cfg->repeat = st->repeat;
+	free(cfg->serdev);
+	cfg->serdev = st->serdev ? strdup(st->serdev) : 0;
+
+	for(i=0; i<NUM_ARRAYS; i++) {
+		dst = cfg_array(cfg, i);
+		for(j=0; j<NUM_CHUNKS; j++) {
+			memcpy(dst + j * CHUNK_SIZE, st->chunk[i][j]->data, sizeof st->chunk[i][j]->data);
+		}
+	}
+}
+
+/* shared chunks are equal by construction, only distinct ones are compared */
+static unsigned int state_diff(const struct state *a, const struct state *b)
+{
+	int i, j;
+	unsigned int fields = 0;
+
+	if(a->sens != b->sens) fields |= CFG_SENS;
+	if(memcmp(a->sens_axis, b->sens_axis, sizeof a->sens_axis) != 0) fields |= CFG_SENS_AXIS;
+	if(a->invert != b->invert) fields |= CFG_INVERT;
+	if(a->swapyz != b->swapyz) fields |= CFG_SWAPYZ;
+	if(a->led != b->led) fields |= CFG_LED;
+	if(a->grab != b->grab) fields |= CFG_GRAB;
+	if(a->repeat != b->repeat) fields |= CFG_REPEAT;
+	if(!streq(a->serdev, b->serdev)) fields |= CFG_SERIAL;
+
+	for(i=0; i<NUM_ARRAYS; i++) {
+		for(j=0; j<NUM_CHUNKS; j++) {
+			if(a->chunk[i][j] != b->chunk[i][j] && memcmp(a->chunk[i][j]->data,
+						b->chunk[i][j]->data, sizeof a->chunk[i][j]->data) != 0) {
+				fields |= arr_flag[i];
+				break;
+			}
+		}
+	}
+	return fields;
+}
+
+void undo_reset(const struct config *cfg)
+{
+	int i;
+
+	for(i=0; i<nhist; i++) {
+		free_state(hist[i]);
+	}
+	nhist = cur = 0;
+
+	if((hist[0] = make_state(cfg, 0))) {
+		nhist = 1;
+	}
+}
+
+void undo_record(const struct config *cfg)
+{
+	int i;
+	unsigned int fields;
+	struct state *st, *top;
+	long long now;
+
+	if(replaying) return;
+	if(!nhist) {
+		undo_reset(cfg);
+		return;
+	}
+
+	top = hist[cur];
+	if(!(st = make_state(cfg, top))) {
+		return;
+	}
+	if(!(fields = state_diff(top, st))) {
+		free_state(st);
+		return;
+	}
+
+	/* a new edit discards the redo states */
+	for(i=cur+1; i<nhist; i++) {
+		free_state(hist[i]);
+	}
+	nhist = cur + 1;
+
+	now = get_usec();
+	st->fields = fields;
+	st->usec = now;
+
+	/* keep dragging a slider a single undo step */
+	if(cur > 0 && top->fields == fields && now - top->usec < UNDO_MERGE_MSEC * 1000) {
+		st->fields = state_diff(hist[cur - 1], st);
+		free_state(top);
+		if(!st->fields) {
+			/* back to the previous state */
+			free_state(st);
+			nhist = cur--;
+			return;
+		}
+		hist[cur] = st;
+		return;
+	}
+
+	if(nhist >= UNDO_MAX_DEPTH) {
+		free_state(hist[0]);
+		memmove(hist, hist + 1, (nhist - 1) * sizeof *hist);
+		nhist--;
+		cur--;
+	}
+	hist[nhist++] = st;
+	cur = nhist - 1;
+}
+
+int undo_can_undo(void)
+{
+	return cur > 0;
+}
+
+int undo_can_redo(void)
+{
+	return cur < nhist - 1;
+}
+
+static int step(int dir)
+{
+	struct config target = {0};
+	unsigned int fields;
+	int res;
+
+	fields = state_diff(hist[cur], hist[cur + dir]);
+	cur += dir;
+
+	copy_cfg(&target, &cfg);
+	restore_state(&target, hist[cur]);
+	merge_cfg(&cfg, &target, fields);
+	free(target.serdev);
+
+	replaying = 1;
+	if(fields) {
+		cfgwr_touch(fields);
+	}
+	res = cfgwr_flush();
+	replaying = 0;
+	return res;
+}
+
+int undo(void)
+{
+	if(!undo_can_undo()) return -1;
+	return step(-1);
+}
+
+int redo(void)
+{
+	if(!undo_can_redo()) return -1;
+	return step(1);
+}
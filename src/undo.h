@@ -0,0 +1,59 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef UNDO_H_
+#define UNDO_H_
+
+#include "spnavcfg.h"
+
+/* undo/redo history of configuration states. The per-axis and per-button
+ * arrays of each state are split into reference counted chunks, which are
+ * shared with the previous state unless they changed, so a typical edit costs
+ * a small state header and a single chunk. The history depth is bounded, the
+ * oldest states are dropped first.
+ */
+
+#define UNDO_MAX_DEPTH	256
+/* successive edits of the same fields within this interval are merged */
+#define UNDO_MERGE_MSEC	750
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* clears the history, making cfg the initial state */
+void undo_reset(const struct config *cfg);
+/* pushes cfg as a new state if it differs from the current one, discarding
+ * any redo states. Called for every change which reaches spacenavd.
+ */
+void undo_record(const struct config *cfg);
+
+int undo_can_undo(void);
+int undo_can_redo(void);
+
+/* steps the global cfg back or forward, and sends only the fields which
+ * differ. Return the number of requests sent, or -1 if there is nothing to
+ * undo/redo.
+ */
+int undo(void);
+int redo(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* UNDO_H_ */
@@ -0,0 +1,32 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef UTIL_H_
+#define UTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* monotonic time in microseconds, from an arbitrary starting point */
+long long get_usec(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* UTIL_H_ */
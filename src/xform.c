@@ -0,0 +1,76 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "xform.h"
+
+void xform_setup(struct xform *xf, const struct config *cfg, int naxes)
+{
+	static const int swap[] = {0, 2, 1, 3, 5, 4};
+	int i, axis;
+
+	memset(xf, 0, sizeof *xf);
+
+	for(i=0; i<XFORM_AXES; i++) {
+		axis = i < naxes ? cfg->map_axis[i] : -1;
+		if(axis < 0 || axis >= 6) {
+			xf->dest[i] = -1;
+			continue;
+		}
+		if(cfg->swapyz) {
+			axis = swap[axis];
+		}
+		xf->dest[i] = axis;
+		xf->dead[i] = cfg->dead_thres[i];
+		xf->scale[i] = cfg->sens * cfg->sens_axis[axis];
+		if(cfg->invert & (1 << axis)) {
+			xf->scale[i] = -xf->scale[i];
+		}
+	}
+}
+
+/* one straight loop per device axis over the whole batch, without branches,
+ * so that the compiler can vectorize it
+ */
+static void xform_axis(const int *restrict src, int *restrict dst, int count, int dead, float scale)
+{
+	int i, v;
+
+	for(i=0; i<count; i++) {
+		v = src[i];
+		/* masked rather than branched, inside the deadzone is all zero bits */
+		v &= ((v > -dead) & (v < dead)) - 1;
+		dst[i] = (int)((float)v * scale);
+	}
+}
+
+void xform_batch(const struct xform *xf, const int *const *raw, int *const *out, int count)
+{
+	int i, mapped = 0;
+
+	for(i=0; i<XFORM_AXES; i++) {
+		if(xf->dest[i] >= 0) {
+			xform_axis(raw[i], out[xf->dest[i]], count, xf->dead[i], xf->scale[i]);
+			mapped |= 1 << xf->dest[i];
+		}
+	}
+	for(i=0; i<6; i++) {
+		if(!(mapped & (1 << i))) {
+			memset(out[i], 0, count * sizeof *out[i]);
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/*
+spnavcfg - an interactive GUI configurator for the spacenavd daemon.
+Copyright (C) 2007-2025 John Tsiombikas <nuclear@mutantstargoat.com>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef XFORM_H_
+#define XFORM_H_
+
+#include "spnavcfg.h"
+
+/* device axes covered by the model. Devices with more axes have the rest
+ * ignored, they're not mapped to anything by default anyway.
+ */
+#define XFORM_AXES	6
+
+/* local model of the spacenavd axis transform: each device axis is zeroed
+ * inside its deadzone, routed to the output axis it's mapped to (after Y/Z
+ * swapping), and scaled by the global and per-axis sensitivity, negated if the
+ * output axis is inverted. xform_setup folds the configuration into one
+ * destination, threshold and scale factor per device axis.
+ */
+struct xform {
+	int dest[XFORM_AXES];		/* output axis, or -1 if unmapped */
+	int dead[XFORM_AXES];
+	float scale[XFORM_AXES];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void xform_setup(struct xform *xf, const struct config *cfg, int naxes);
+
+/* runs count samples through the transform. raw[i] and out[i] point to count
+ * consecutive values of device axis i and output axis i respectively. If more
+ * than one device axis maps to the same output axis, the last one wins, and
+ * output axes without a device axis are zeroed.
+ */
+void xform_batch(const struct xform *xf, const int *const *raw, int *const *out, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* XFORM_H_ */